@@ -0,0 +1,232 @@
+#pragma once
+
+/// @defgroup FastClock Fast Clock
+/// @brief Low-overhead wall clock that reads the CPU timestamp counter.
+/// @{
+///
+/// Reading std::chrono::steady_clock usually costs a call into the OS's time facility, which adds up when the clock is
+/// read in tight loops (e.g. once per waiting task, or once per task resume to measure its cost). FastClock instead
+/// reads the CPU's timestamp counter (RDTSC on x86, CNTVCT on ARM64), and converts it to nanoseconds using a ratio that
+/// is calibrated against steady_clock the first time the clock is used (taking about 2ms).
+///
+/// FastClock meets the requirements of a std::chrono clock, so it can be used anywhere steady_clock can, and its time
+/// points share steady_clock's epoch. FastClock::Now() returns the time since calibration as a task time, and can be
+/// passed directly to any time-sensitive awaiter:
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+///
+/// co_await WaitSeconds(0.5f, FastClock::Now);
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Setting SQUID_ENABLE_FAST_CLOCK in TasksConfig.h makes FastClock the clock that a @ref TaskManager uses to measure
+/// update budgets, resume deadlines and per-group resume times (see @ref tTaskClock).
+///
+/// Each thread re-syncs its reading of the clock with steady_clock every 100ms, so calibration error cannot accumulate
+/// into drift over long uptimes (and time never moves backwards on any one thread). Reading the clock takes no locks and
+/// writes no shared state, so it is cheap to call from any thread. On CPUs without an invariant timestamp counter (one
+/// that ticks at a constant rate, in sync across cores), and on other architectures, FastClock falls back to reading
+/// steady_clock.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SQUID_FAST_CLOCK_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define SQUID_FAST_CLOCK_X86 1
+#else
+#define SQUID_FAST_CLOCK_X86 0
+#endif
+
+#include "Task.h"
+
+NAMESPACE_SQUID_BEGIN
+
+//--- FastClock ---//
+/// Steady wall clock that reads the CPU timestamp counter (calibrated against std::chrono::steady_clock)
+class FastClock
+{
+public:
+	using rep = int64_t; ///< Tick count type (std::chrono clock requirement)
+	using period = std::nano; ///< Tick period (std::chrono clock requirement)
+	using duration = std::chrono::nanoseconds; ///< Duration type (std::chrono clock requirement)
+	using time_point = std::chrono::time_point<FastClock>; ///< Time point type, with the same epoch as steady_clock (std::chrono clock requirement)
+	static constexpr bool is_steady = true; ///< Whether the clock never moves backwards (std::chrono clock requirement)
+
+	/// Returns the current time point (std::chrono clock requirement)
+	static time_point now() noexcept
+	{
+		const Calibration& calibration = GetCalibration();
+		if(!calibration.isUsingCounter)
+		{
+			return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+		}
+		ThreadSync& threadSync = GetThreadSync();
+		uint64_t counter = ReadCounter();
+		if(counter - threadSync.baseCounter >= calibration.syncIntervalTicks || !threadSync.isSynced)
+		{
+			Sync(calibration, threadSync);
+			counter = threadSync.baseCounter;
+		}
+		return time_point(duration(threadSync.baseNanoseconds + (int64_t)((double)(counter - threadSync.baseCounter) * threadSync.nanosecondsPerTick)));
+	}
+
+	/// Returns the time since the clock was calibrated, as a task time (usable as a time-stream function)
+	static tTaskTime Now()
+	{
+		return TaskTimeFromSeconds(GetSeconds());
+	}
+
+	/// Returns the time since the clock was calibrated, in seconds
+	static double GetSeconds()
+	{
+		std::chrono::duration<double> elapsed = now().time_since_epoch() - duration(GetCalibration().baseNanoseconds);
+		return elapsed.count();
+	}
+
+	/// Returns whether the clock reads the CPU timestamp counter (rather than falling back to steady_clock)
+	static bool IsUsingTimestampCounter()
+	{
+		return GetCalibration().isUsingCounter;
+	}
+
+	/// Returns the calibrated frequency of the CPU timestamp counter, in ticks per second (0 if it is not being used)
+	static double GetCounterFrequency()
+	{
+		const Calibration& calibration = GetCalibration();
+		return calibration.isUsingCounter ? 1.0e9 / calibration.nanosecondsPerTick : 0.0;
+	}
+
+private:
+	// Process-wide calibration (immutable once made)
+	struct Calibration
+	{
+		uint64_t baseCounter = 0; // Counter value at the end of calibration
+		int64_t baseNanoseconds = 0; // steady_clock time at the end of calibration
+		double nanosecondsPerTick = 0.0;
+		uint64_t syncIntervalTicks = 0; // Number of ticks between each thread's re-syncs with steady_clock
+		bool isUsingCounter = false;
+	};
+
+	// Per-thread sync with steady_clock (re-made periodically, so that calibration error cannot accumulate)
+	struct ThreadSync
+	{
+		uint64_t baseCounter = 0; // Counter value at the last sync
+		int64_t baseNanoseconds = 0; // Clock time at the last sync
+		double nanosecondsPerTick = 0.0; // Rate until the next sync
+		bool isSynced = false;
+	};
+
+	static const Calibration& GetCalibration()
+	{
+		static const Calibration s_calibration = Calibrate(std::chrono::milliseconds(2)); // (Thread-safe, and only done once)
+		return s_calibration;
+	}
+	static ThreadSync& GetThreadSync()
+	{
+		static thread_local ThreadSync t_threadSync; // (Constant-initialized, so access needs no guard)
+		return t_threadSync;
+	}
+	static Calibration Calibrate(std::chrono::steady_clock::duration in_interval)
+	{
+		Calibration calibration;
+		calibration.baseNanoseconds = std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		if(!HasInvariantCounter())
+		{
+			return calibration;
+		}
+
+		// Measure the counter against steady_clock over the calibration interval
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+		uint64_t startCounter = ReadCounter();
+		std::chrono::steady_clock::time_point endTime;
+		do
+		{
+			endTime = std::chrono::steady_clock::now();
+		} while(endTime - startTime < in_interval);
+		uint64_t endCounter = ReadCounter();
+		if(endCounter <= startCounter)
+		{
+			return calibration;
+		}
+		calibration.baseCounter = endCounter;
+		calibration.baseNanoseconds = std::chrono::duration_cast<duration>(endTime.time_since_epoch()).count();
+		calibration.nanosecondsPerTick = (double)std::chrono::duration_cast<duration>(endTime - startTime).count() / (double)(endCounter - startCounter);
+		calibration.syncIntervalTicks = (uint64_t)(1.0e8 / calibration.nanosecondsPerTick); // 100ms
+		calibration.isUsingCounter = true;
+		return calibration;
+	}
+	static void Sync(const Calibration& in_calibration, ThreadSync& io_threadSync)
+	{
+		// Measure the counter rate over the whole time since calibration (which grows more precise the longer the process runs)
+		int64_t steadyNanoseconds = std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		uint64_t counter = ReadCounter();
+		double nanosecondsPerTick = in_calibration.nanosecondsPerTick;
+		if(counter - in_calibration.baseCounter >= in_calibration.syncIntervalTicks)
+		{
+			nanosecondsPerTick = (double)(steadyNanoseconds - in_calibration.baseNanoseconds) / (double)(counter - in_calibration.baseCounter);
+		}
+
+		// Re-anchor at steady_clock's time, unless that would move this thread's clock backwards (in which case the rate is
+		// slowed until the next sync, so the clock converges on steady_clock without ever reversing)
+		int64_t nanoseconds = steadyNanoseconds;
+		if(io_threadSync.isSynced)
+		{
+			int64_t extrapolatedNanoseconds = io_threadSync.baseNanoseconds + (int64_t)((double)(counter - io_threadSync.baseCounter) * io_threadSync.nanosecondsPerTick);
+			if(extrapolatedNanoseconds > steadyNanoseconds)
+			{
+				nanoseconds = extrapolatedNanoseconds;
+				double syncIntervalNanoseconds = (double)in_calibration.syncIntervalTicks * nanosecondsPerTick;
+				nanosecondsPerTick *= std::max(1.0 - (double)(extrapolatedNanoseconds - steadyNanoseconds) / syncIntervalNanoseconds, 0.5);
+			}
+		}
+		io_threadSync.baseCounter = counter;
+		io_threadSync.baseNanoseconds = nanoseconds;
+		io_threadSync.nanosecondsPerTick = nanosecondsPerTick;
+		io_threadSync.isSynced = true;
+	}
+	static bool HasInvariantCounter()
+	{
+#if SQUID_FAST_CLOCK_X86
+		// CPUID leaf 0x80000007 reports an invariant TSC in bit 8 of EDX
+#if defined(_MSC_VER)
+		int regs[4] = {};
+		__cpuid(regs, 0x80000000);
+		if((unsigned)regs[0] < 0x80000007u)
+		{
+			return false;
+		}
+		__cpuid(regs, 0x80000007);
+		return (regs[3] & (1 << 8)) != 0;
+#else
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8)) != 0;
+#endif // defined(_MSC_VER)
+#elif defined(__aarch64__)
+		return true; // The generic timer's virtual counter always ticks at a constant rate
+#else
+		return false;
+#endif //SQUID_FAST_CLOCK_X86
+	}
+	static uint64_t ReadCounter()
+	{
+#if SQUID_FAST_CLOCK_X86
+		return __rdtsc();
+#elif defined(__aarch64__)
+		uint64_t counter;
+		asm volatile("mrs %0, cntvct_el0" : "=r"(counter));
+		return counter;
+#else
+		return 0;
+#endif //SQUID_FAST_CLOCK_X86
+	}
+};
+
+NAMESPACE_SQUID_END
+
+///@} end of FastClock group
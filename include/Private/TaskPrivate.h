@@ -5,12 +5,15 @@ enum class eTaskRef;
 template <typename tRet> class TaskPromise;
 class TaskInternalBase;
 template <typename tRet> class TaskInternal;
+class TaskTimer;
 
 //--- tTaskReadyFn ---//
 using tTaskReadyFn = std::function<bool()>;
 
 template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
 auto CancelTaskIf(Task<tRet, RefType, Resumable>&& in_task, tTaskCancelFn in_cancelFn);
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+auto CancelTaskIfStopRequested(Task<tRet, RefType, Resumable>&& in_task);
 
 template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
 auto StopTaskIf(Task<tRet, RefType, Resumable>&& in_task, tTaskCancelFn in_cancelFn);
@@ -96,6 +99,11 @@ private:
 };
 #endif //SQUID_ENABLE_TASK_DEBUG
 
+//--- SuspendForever Awaiter ---//
+struct SuspendForever // Suspends until killed (lets schedulers know the task will never be ready)
+{
+};
+
 //--- AddStopTask Awaiter ---//
 template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
 struct AddStopTaskAwaiter
@@ -116,6 +124,43 @@ auto AddStopTask(Task<tRet, RefType, Resumable>& in_taskToStop)
 	return AddStopTaskAwaiter<tRet, RefType, Resumable>(in_taskToStop);
 };
 
+//--- WaitForInnerTask Awaiter ---//
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+struct InnerTaskAwaiter // Suspends a wrapper task until the inner task it resumes by hand is ready (e.g. in CancelIf())
+{
+	InnerTaskAwaiter(Task<tRet, RefType, Resumable>& in_innerTask, tTaskCancelFn in_cancelFn, bool in_isCancelFnPolled, const TaskTimer* in_timer)
+		: m_innerTask(&in_innerTask)
+		, m_cancelFn(std::move(in_cancelFn))
+		, m_isCancelFnPolled(in_isCancelFnPolled)
+		, m_timer(in_timer)
+	{
+	}
+
+private:
+	template <typename tOtherRet> friend class TaskPromiseBase;
+	Task<tRet, RefType, Resumable>* m_innerTask = nullptr;
+	tTaskCancelFn m_cancelFn; // Condition that also wakes the wrapper (if any)
+	bool m_isCancelFnPolled = false; // Whether the condition must be polled (rather than only changing alongside a stop request or external wake)
+	const TaskTimer* m_timer = nullptr; // Timer that also wakes the wrapper (if any)
+};
+
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+auto WaitForInnerTask(Task<tRet, RefType, Resumable>& in_innerTask, tTaskCancelFn in_cancelFn = {}) // Wake when the task or a polled cancel function is ready
+{
+	bool isPolled = (bool)in_cancelFn;
+	return InnerTaskAwaiter<tRet, RefType, Resumable>(in_innerTask, std::move(in_cancelFn), isPolled, nullptr);
+};
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+auto WaitForInnerTask(Task<tRet, RefType, Resumable>& in_innerTask, ExternalReadyFn in_cancelFn) // Wake when the task or an unpolled cancel function is ready
+{
+	return InnerTaskAwaiter<tRet, RefType, Resumable>(in_innerTask, std::move(in_cancelFn.readyFn), false, nullptr);
+};
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+auto WaitForInnerTask(Task<tRet, RefType, Resumable>& in_innerTask, const TaskTimer& in_timer) // Wake when the task is ready or the timer expires
+{
+	return InnerTaskAwaiter<tRet, RefType, Resumable>(in_innerTask, {}, false, &in_timer);
+};
+
 //--- RemoveStopTask Awaiter ---//
 template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
 struct RemoveStopTaskAwaiter
@@ -322,6 +367,105 @@ private:
 	std::shared_future<tRet> m_sharedFuture;
 };
 
+#if SQUID_ENABLE_TASK_FRAME_POOL
+//--- TaskFramePool ---//
+// Per-thread free lists of coroutine frame allocations, bucketed by size class
+class TaskFramePool
+{
+public:
+	static constexpr size_t k_sizeClassBytes = 64;
+	static constexpr size_t k_numSizeClasses = 32; // Frames larger than 2KB are allocated directly
+
+	static void* Allocate(size_t in_size) noexcept
+	{
+		LastFrameSize() = in_size;
+		size_t sizeClass = GetSizeClass(in_size);
+		Pools* pools = GetPools();
+		if(sizeClass < k_numSizeClasses && pools && pools->freeLists[sizeClass])
+		{
+			FreeBlock* block = pools->freeLists[sizeClass];
+			pools->freeLists[sizeClass] = block->next;
+			return block;
+		}
+		return ::operator new(GetAllocSize(in_size), std::nothrow);
+	}
+	static void Free(void* in_ptr, size_t in_size) noexcept
+	{
+		size_t sizeClass = GetSizeClass(in_size);
+		Pools* pools = GetPools();
+		if(sizeClass < k_numSizeClasses && pools)
+		{
+			// Blocks are allocated individually, so a block freed on a different thread simply joins that thread's pool
+			FreeBlock* block = static_cast<FreeBlock*>(in_ptr);
+			block->next = pools->freeLists[sizeClass];
+			pools->freeLists[sizeClass] = block;
+			return;
+		}
+		::operator delete(in_ptr);
+	}
+	static void Reserve(size_t in_numFrames, size_t in_frameSize)
+	{
+		size_t sizeClass = GetSizeClass(in_frameSize);
+		SQUID_RUNTIME_CHECK(sizeClass < k_numSizeClasses, "Frame size is too large to be pooled");
+		for(size_t i = 0; i < in_numFrames; ++i)
+		{
+			void* ptr = ::operator new(GetAllocSize(in_frameSize));
+			Free(ptr, in_frameSize);
+		}
+	}
+	static size_t& LastFrameSize() // Size of the last frame allocated on this thread
+	{
+		thread_local size_t s_lastFrameSize = 0;
+		return s_lastFrameSize;
+	}
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+	struct Pools
+	{
+		~Pools()
+		{
+			IsDestroyed() = true; // Frames freed after this thread's pools are destroyed are deleted directly
+			for(FreeBlock* freeList : freeLists)
+			{
+				while(freeList)
+				{
+					FreeBlock* next = freeList->next;
+					::operator delete(freeList);
+					freeList = next;
+				}
+			}
+		}
+		FreeBlock* freeLists[k_numSizeClasses] = {};
+	};
+	static bool& IsDestroyed()
+	{
+		thread_local bool s_isDestroyed = false;
+		return s_isDestroyed;
+	}
+	static Pools* GetPools()
+	{
+		if(IsDestroyed())
+		{
+			return nullptr;
+		}
+		thread_local Pools s_pools;
+		return &s_pools;
+	}
+	static size_t GetSizeClass(size_t in_size)
+	{
+		return (in_size - 1) / k_sizeClassBytes;
+	}
+	static size_t GetAllocSize(size_t in_size)
+	{
+		return (GetSizeClass(in_size) + 1) * k_sizeClassBytes;
+	}
+};
+#endif //SQUID_ENABLE_TASK_FRAME_POOL
+
 //--- TaskPromiseBase ---//
 template <typename tRet>
 class TaskPromiseBase
@@ -356,6 +500,16 @@ public:
 		SQUID_THROW(std::bad_alloc(), "Failed to allocate memory for Task");
 		return {};
 	}
+#if SQUID_ENABLE_TASK_FRAME_POOL
+	static void* operator new(size_t in_size) noexcept
+	{
+		return TaskFramePool::Allocate(in_size);
+	}
+	static void operator delete(void* in_ptr, size_t in_size) noexcept
+	{
+		TaskFramePool::Free(in_ptr, in_size);
+	}
+#endif //SQUID_ENABLE_TASK_FRAME_POOL
 	void unhandled_exception() noexcept
 	{
 #if SQUID_USE_EXCEPTIONS
@@ -417,6 +571,13 @@ public:
 		return std::suspend_never();
 	}
 
+	template <typename tInnerRet, eTaskRef RefType, eTaskResumable Resumable>
+	auto await_transform(InnerTaskAwaiter<tInnerRet, RefType, Resumable> in_awaiter)
+	{
+		m_taskInternal->SetReadyInnerTask(*in_awaiter.m_innerTask, std::move(in_awaiter.m_cancelFn), in_awaiter.m_isCancelFnPolled, in_awaiter.m_timer);
+		return std::suspend_always();
+	}
+
 	auto await_transform(GetStopContext in_awaiter)
 	{
 		struct GetStopContextAwaiter : public std::suspend_never
@@ -434,6 +595,31 @@ public:
 		GetStopContextAwaiter stopCtxAwaiter{ m_taskInternal->GetStopContext() };
 		return stopCtxAwaiter;
 	}
+	auto await_transform(const TaskTimer& in_timer)
+	{
+		// Check if the timer has already expired, and suspend if it has not
+		bool isReady = in_timer.IsExpired();
+		if(!isReady)
+		{
+			m_taskInternal->SetReadyTimer(in_timer);
+		}
+		return SuspendIf(!isReady);
+	}
+	auto await_transform(const ExternalReadyFn& in_awaiter)
+	{
+		// Check if we are already ready, and suspend if we are not
+		bool isReady = in_awaiter.readyFn();
+		if(!isReady)
+		{
+			m_taskInternal->SetExternalReadyFunction(in_awaiter.readyFn);
+		}
+		return SuspendIf(!isReady);
+	}
+	auto await_transform(SuspendForever)
+	{
+		m_taskInternal->SetWaitingForever();
+		return std::suspend_always();
+	}
 	auto await_transform(const tTaskReadyFn& in_taskReadyFn)
 	{
 		// Check if we are already ready, and suspend if we are not
@@ -521,10 +707,20 @@ public:
 	~TaskInternalBase() // NOTE: Destructor is intentionally non-virtual (shared_ptr preserves concrete type via deleter)
 	{
 		Kill(); // Used for killing subtasks
+
+		// Detach any stop callbacks and timers that outlived the coroutine (so their destructors do not touch this task)
+		while(m_stopCallbacks)
+		{
+			RemoveStopCallback(m_stopCallbacks);
+		}
+		while(m_timers)
+		{
+			RemoveTimer(m_timers);
+		}
 	}
-	StopContext GetStopContext() const
+	StopContext GetStopContext()
 	{
-		return { &m_isStopRequested };
+		return { this, &m_isStopRequested };
 	}
 	bool IsStopRequested() const
 	{
@@ -533,6 +729,21 @@ public:
 	void RequestStop() // Propagates a request for the task to come to a 'graceful' stop
 	{
 		m_isStopRequested = true;
+
+		// Invoke stop callbacks (each is detached before it is called, so it is invoked exactly once)
+		while(m_stopCallbacks)
+		{
+			StopCallback* stopCallback = m_stopCallbacks;
+			RemoveStopCallback(stopCallback);
+			stopCallback->m_fn();
+		}
+#if SQUID_HAS_STOP_TOKEN
+		if(m_stopSource.stop_possible())
+		{
+			m_stopSource.request_stop();
+		}
+#endif //SQUID_HAS_STOP_TOKEN
+
 		for(auto& stopTask : m_stopTasks)
 		{
 			if(auto locked = stopTask.lock())
@@ -570,6 +781,124 @@ public:
 			}
 		}
 	}
+
+	// Stop callbacks
+	void AddStopCallback(StopCallback* in_stopCallback) // Registers a callback (or invokes it immediately if a stop was already requested)
+	{
+		if(m_isStopRequested)
+		{
+			in_stopCallback->m_fn();
+			return;
+		}
+		in_stopCallback->m_taskInternal = this;
+		in_stopCallback->m_prev = nullptr;
+		in_stopCallback->m_next = m_stopCallbacks;
+		if(m_stopCallbacks)
+		{
+			m_stopCallbacks->m_prev = in_stopCallback;
+		}
+		m_stopCallbacks = in_stopCallback;
+	}
+	void RemoveStopCallback(StopCallback* in_stopCallback) // Deregisters a callback without invoking it
+	{
+		if(in_stopCallback->m_prev)
+		{
+			in_stopCallback->m_prev->m_next = in_stopCallback->m_next;
+		}
+		else
+		{
+			m_stopCallbacks = in_stopCallback->m_next;
+		}
+		if(in_stopCallback->m_next)
+		{
+			in_stopCallback->m_next->m_prev = in_stopCallback->m_prev;
+		}
+		in_stopCallback->m_taskInternal = nullptr;
+		in_stopCallback->m_prev = nullptr;
+		in_stopCallback->m_next = nullptr;
+	}
+#if SQUID_HAS_STOP_TOKEN
+	std::stop_token GetStopToken() // Lazily creates a std::stop_source, so tasks that never ask for a token pay nothing
+	{
+		if(!m_stopSource.stop_possible())
+		{
+			m_stopSource = std::stop_source();
+			if(m_isStopRequested)
+			{
+				m_stopSource.request_stop();
+			}
+		}
+		return m_stopSource.get_token();
+	}
+#endif //SQUID_HAS_STOP_TOKEN
+
+	// Timers
+	static TaskInternalBase*& GetResumingRootTask() // Outermost task currently being resumed on this thread (timers register with it)
+	{
+		thread_local TaskInternalBase* s_rootTask = nullptr;
+		return s_rootTask;
+	}
+	void AddTimer(TaskTimer* in_timer)
+	{
+		in_timer->m_taskInternal = this;
+		in_timer->m_prev = nullptr;
+		in_timer->m_next = m_timers;
+		if(m_timers)
+		{
+			m_timers->m_prev = in_timer;
+		}
+		m_timers = in_timer;
+		if(m_isTimersPaused)
+		{
+			in_timer->Pause(); // Timers started by a paused task start paused
+		}
+	}
+	void RemoveTimer(TaskTimer* in_timer)
+	{
+		if(in_timer->m_prev)
+		{
+			in_timer->m_prev->m_next = in_timer->m_next;
+		}
+		else
+		{
+			m_timers = in_timer->m_next;
+		}
+		if(in_timer->m_next)
+		{
+			in_timer->m_next->m_prev = in_timer->m_prev;
+		}
+		in_timer->m_taskInternal = nullptr;
+		in_timer->m_prev = nullptr;
+		in_timer->m_next = nullptr;
+	}
+	void PauseTimers() // Pauses all timers registered with this task
+	{
+		m_isTimersPaused = true;
+		for(TaskTimer* timer = m_timers; timer; timer = timer->m_next)
+		{
+			timer->Pause();
+		}
+	}
+	void UnpauseTimers() // Unpauses all timers registered with this task (shifting their deadlines by the paused duration)
+	{
+		m_isTimersPaused = false;
+		for(TaskTimer* timer = m_timers; timer; timer = timer->m_next)
+		{
+			timer->Unpause();
+		}
+	}
+	bool HasExpiredTimers() const // Returns whether any timer registered with this task has expired
+	{
+		for(TaskTimer* timer = m_timers; timer; timer = timer->m_next)
+		{
+			if(timer->IsExpired())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 	eTaskStatus Resume() // Returns whether the task is still running
 	{
 		// Make sure this task is not already mid-resume
@@ -581,6 +910,29 @@ public:
 			return eTaskStatus::Done;
 		}
 
+		// Track the outermost task being resumed (restored when this function returns)
+		struct RootTaskScope
+		{
+			RootTaskScope(TaskInternalBase* in_task)
+				: rootTask(GetResumingRootTask())
+				, isRoot(!rootTask)
+			{
+				if(isRoot)
+				{
+					rootTask = in_task;
+				}
+			}
+			~RootTaskScope()
+			{
+				if(isRoot)
+				{
+					rootTask = nullptr;
+				}
+			}
+			TaskInternalBase*& rootTask;
+			bool isRoot;
+		} rootTaskScope(this);
+
 		// Mark task as resuming
 		m_internalState = eInternalState::Resuming;
 
@@ -588,9 +940,9 @@ public:
 		if(m_subTaskInternal)
 		{
 			// Propagate any stop requests to sub-task prior to resuming
-			if(m_isStopRequested)
+			if(m_isStopRequested && !m_subTaskInternal->m_isStopRequested)
 			{
-				m_subTaskInternal->m_isStopRequested = true;
+				m_subTaskInternal->RequestStop();
 			}
 
 			// Resume the sub-task
@@ -608,6 +960,8 @@ public:
 		if(CanResume())
 		{
 			m_taskReadyFn = nullptr; // Clear any ready function we were waiting on
+			m_readyFnMetUpdateIdx = 0;
+			m_readyInnerTask = nullptr;
 			m_coroHandle.resume(); // Resume the underlying std::coroutine_handle
 		}
 
@@ -682,6 +1036,7 @@ private:
 	template <typename tRet> friend class TaskPromiseBase;
 	template <typename tRet, eTaskRef RefType, eTaskResumable Resumable, typename promise_type> friend struct TaskAwaiterBase;
 	template <typename tRet, eTaskRef RefType, eTaskResumable Resumable> friend class Task;
+	friend class TaskManager;
 
 	// Kill this task
 	void Kill() // Kill() can safely be called multiple times
@@ -710,6 +1065,89 @@ private:
 	void SetReadyFunction(const tTaskReadyFn& in_taskReadyFn)
 	{
 		m_taskReadyFn = in_taskReadyFn;
+		m_readyFnMetUpdateIdx = 0;
+		m_readyTimer = nullptr;
+		m_isWaitingForever = false;
+		m_isReadyFnExternal = false;
+		m_readyInnerTask = nullptr;
+		m_isReadyFnPolled = false;
+	}
+	void SetExternalReadyFunction(const tTaskReadyFn& in_taskReadyFn) // Wait on a function that only becomes ready alongside an external wake
+	{
+		SetReadyFunction(in_taskReadyFn);
+		m_isReadyFnExternal = true;
+	}
+	void SetReadyTimer(const TaskTimer& in_timer) // Wait until a timer expires
+	{
+		SetReadyFunction([&in_timer] { return in_timer.IsExpired(); });
+		m_readyTimer = &in_timer;
+	}
+	void SetWaitingForever() // Wait until killed
+	{
+		SetReadyFunction([] { return false; });
+		m_isWaitingForever = true;
+	}
+	template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+	void SetReadyInnerTask(Task<tRet, RefType, Resumable>& in_innerTask, tTaskCancelFn in_cancelFn, bool in_isCancelFnPolled, const TaskTimer* in_timer) // Wait until an inner task that we resume by hand is ready (or a cancel function or timer fires)
+	{
+		std::shared_ptr<TaskInternalBase> innerTaskInternal = in_innerTask.GetInternalTask();
+		if(!innerTaskInternal)
+		{
+			SetReadyFunction({}); // (Resume every update)
+			return;
+		}
+		SetReadyFunction([innerTask = innerTaskInternal.get(), cancelFn = std::move(in_cancelFn), in_timer] {
+			return innerTask->CanResume() || (cancelFn && cancelFn()) || (in_timer && in_timer->IsExpired());
+		});
+		m_readyTimer = in_timer;
+		m_readyInnerTask = std::move(innerTaskInternal);
+		m_isReadyFnPolled = in_isCancelFnPolled;
+	}
+	static TaskWakeTime GetTimerWakeTime(const TaskTimer& in_timer) // Estimate of when a timer will expire
+	{
+		if(in_timer.IsPaused())
+		{
+			return {};
+		}
+		tTaskTime timeRemaining = in_timer.GetRemainingSourceTime();
+		return timeRemaining > 0 ? TaskWakeTime{ TaskWakeTime::eType::Timer, timeRemaining } : TaskWakeTime{ TaskWakeTime::eType::Now, {} };
+	}
+	TaskWakeTime GetWakeTime() const // Estimate of when this task will next be ready to resume
+	{
+		if(IsDone() || m_isWaitingForever)
+		{
+			return {};
+		}
+		if(m_subTaskInternal)
+		{
+			return m_subTaskInternal->GetWakeTime();
+		}
+		if(!m_taskReadyFn)
+		{
+			return { TaskWakeTime::eType::Now, {} };
+		}
+		if(m_readyInnerTask) // Wrappers that resume an inner task by hand wake when the inner task does
+		{
+			if(CanResume())
+			{
+				return { TaskWakeTime::eType::Now, {} };
+			}
+			TaskWakeTime wakeTime = m_readyInnerTask->GetWakeTime();
+			if(m_readyTimer)
+			{
+				wakeTime = TaskWakeTime::Earliest(wakeTime, GetTimerWakeTime(*m_readyTimer));
+			}
+			return m_isReadyFnPolled ? TaskWakeTime::Earliest(wakeTime, { TaskWakeTime::eType::Unknown, {} }) : wakeTime;
+		}
+		if(m_readyTimer)
+		{
+			return GetTimerWakeTime(*m_readyTimer);
+		}
+		if(m_taskReadyFn())
+		{
+			return { TaskWakeTime::eType::Now, {} };
+		}
+		return m_isReadyFnExternal ? TaskWakeTime{} : TaskWakeTime{ TaskWakeTime::eType::Unknown, {} }; // External events wake the scheduler
 	}
 	bool CanResume() const
 	{
@@ -722,9 +1160,44 @@ private:
 			bool canResume = m_subTaskInternal->CanResume();
 			return canResume;
 		}
-		bool isReady = !m_taskReadyFn || m_taskReadyFn();
+		if(!m_taskReadyFn)
+		{
+			return true;
+		}
+		uint64_t updateIdx = GetCurrentUpdateIdx();
+		if(updateIdx && m_readyFnMetUpdateIdx == updateIdx)
+		{
+			return true; // Already met earlier in this update (so a wake check followed by a resume only evaluates it once)
+		}
+		bool isReady = m_taskReadyFn();
+		m_readyFnMetUpdateIdx = isReady ? updateIdx : 0;
 		return isReady;
 	}
+
+	// Task manager updates (within which a ready function that has returned true is not evaluated again)
+	static uint64_t& GetCurrentUpdateIdx() // Index of the task manager update in progress on this thread (0 outside of updates)
+	{
+		thread_local uint64_t s_updateIdx = 0;
+		return s_updateIdx;
+	}
+	struct UpdateScope // Gives each task manager update a unique index (restoring the index of any enclosing update on exit)
+	{
+		UpdateScope()
+			: m_prevUpdateIdx(GetCurrentUpdateIdx())
+		{
+			static std::atomic<uint64_t> s_nextUpdateIdx = 1; // Process-wide, so no two updates share an index
+			GetCurrentUpdateIdx() = s_nextUpdateIdx.fetch_add(1, std::memory_order_relaxed);
+		}
+		~UpdateScope()
+		{
+			GetCurrentUpdateIdx() = m_prevUpdateIdx;
+		}
+		UpdateScope(const UpdateScope&) = delete;
+		UpdateScope& operator=(const UpdateScope&) = delete;
+
+	private:
+		uint64_t m_prevUpdateIdx;
+	};
 	bool IsDone() const
 	{
 		return m_isDone;
@@ -742,6 +1215,12 @@ private:
 
 	// Task ready condition (when awaiting a std::function<bool>)
 	tTaskReadyFn m_taskReadyFn;
+	mutable uint64_t m_readyFnMetUpdateIdx = 0; // Update in which the ready function returned true (0 if not met)
+	const TaskTimer* m_readyTimer = nullptr; // Set when the ready condition is a timer expiring
+	bool m_isWaitingForever = false; // Set when the ready condition can never be met
+	bool m_isReadyFnExternal = false; // Set when the ready condition is only met alongside an external wake
+	std::shared_ptr<TaskInternalBase> m_readyInnerTask; // Set when the ready condition is an inner task being ready (see SetReadyInnerTask())
+	bool m_isReadyFnPolled = false; // Set when the inner-task ready condition also polls a cancel function
 
 #if SQUID_USE_EXCEPTIONS
 	// Exceptions
@@ -773,6 +1252,14 @@ private:
 	// Stop request
 	bool m_isStopRequested = false;
 	std::vector<std::weak_ptr<TaskInternalBase>> m_stopTasks;
+	StopCallback* m_stopCallbacks = nullptr; // Intrusive list of registered stop callbacks
+
+	// Timers
+	TaskTimer* m_timers = nullptr; // Intrusive list of registered timers
+	bool m_isTimersPaused = false;
+#if SQUID_HAS_STOP_TOKEN
+	std::stop_source m_stopSource{ std::nostopstate }; // Only allocated once a std::stop_token is requested
+#endif //SQUID_HAS_STOP_TOKEN
 
 #if SQUID_ENABLE_TASK_DEBUG
 	// Debug Data
@@ -28,15 +28,30 @@ namespace Squid {} // Convenience to allow 'using namespace Squid' even when nam
 #define SQUID_RUNTIME_CHECK(condition, errStr) assert((condition) && errStr);
 #endif //__cpp_exceptions
 
+// Assert-only check (for destructors and other noexcept contexts, where a failed SQUID_RUNTIME_CHECK would throw into std::terminate())
+#include <cassert>
+#define SQUID_NOTHROW_CHECK(condition, errStr) assert((condition) && errStr);
+
 // Time Interface
+#include <cstdint>
 NAMESPACE_SQUID_BEGIN
-#if SQUID_ENABLE_DOUBLE_PRECISION_TIME
+#if SQUID_TIME_TICKS
+using tTaskTime = int64_t; // Integer ticks (SQUID_TIME_TICKS ticks per second)
+#elif SQUID_ENABLE_DOUBLE_PRECISION_TIME
 using tTaskTime = double;
 #else
 using tTaskTime = float; // Defines time units for use with the Task system
-#endif //SQUID_ENABLE_DOUBLE_PRECISION_TIME
+#endif //SQUID_TIME_TICKS
 NAMESPACE_SQUID_END
 
+// SIMD support (enabled/disabled via SQUID_ENABLE_SIMD)
+#if SQUID_ENABLE_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define SQUID_HAS_SSE2 1
+#else
+#define SQUID_HAS_SSE2 0
+#endif //SQUID_ENABLE_SIMD
+
 // Coroutine de-optimization macros [DEPRECATED]
 #ifdef _MSC_VER
 #if _MSC_VER >= 1920
@@ -212,5 +227,17 @@ namespace std
 };
 #endif
 
+// C++20 Compatibility (std::stop_token)
+#if HAS_CXX20 && defined(__has_include)
+	#if __has_include(<stop_token>)
+	#include <stop_token>
+	#endif
+#endif
+#if defined(__cpp_lib_jthread)
+#define SQUID_HAS_STOP_TOKEN 1
+#else
+#define SQUID_HAS_STOP_TOKEN 0
+#endif
+
 #undef HAS_CXX17
 #undef HAS_CXX20
@@ -10,10 +10,16 @@
  /// @defgroup Awaiters Awaiters
  /// @brief Versatile task awaiters that offer utility to most projects
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 //--- User configuration header ---//
 #include "TasksConfig.h"
@@ -91,7 +97,19 @@ struct Suspend : public std::suspend_always
 {
 };
 
+//--- External Ready Function Awaiter ---//
+/// @brief Awaiter that waits until a ready function returns true, where the function only becomes true as the result
+/// of an external event that also wakes the scheduler (e.g. an I/O completion followed by TaskRunLoop::Wake())
+/// @details Behaves exactly like awaiting the ready function itself, except that schedulers treat the task as asleep
+/// until the function returns true (see @ref TaskManager::GetNextWakeTime()), rather than polling it.
+struct ExternalReadyFn
+{
+	std::function<bool()> readyFn; ///< Ready function (must only become true alongside an external wake)
+};
+
 //--- Stop Context ---//
+class TaskInternalBase;
+
 /// Context for a task's stop requests (undefined behavior if used after the underlying task is destroyed)
 struct StopContext
 {
@@ -99,18 +117,45 @@ struct StopContext
 	{
 		return *m_isStoppedPtr;
 	}
+#if SQUID_HAS_STOP_TOKEN
+	std::stop_token GetStopToken() const; ///< Returns a std::stop_token that is signaled when a stop is requested on the task
+#endif //SQUID_HAS_STOP_TOKEN
 
 protected:
 	friend class TaskInternalBase;
-	StopContext(const bool* in_isStoppedPtr)
-		: m_isStoppedPtr(in_isStoppedPtr)
+	friend class StopCallback;
+	StopContext(TaskInternalBase* in_taskInternal, const bool* in_isStoppedPtr)
+		: m_taskInternal(in_taskInternal)
+		, m_isStoppedPtr(in_isStoppedPtr)
 	{
 	}
 
 private:
+	TaskInternalBase* m_taskInternal = nullptr;
 	const bool* m_isStoppedPtr = nullptr;
 };
 
+//--- Stop Callback ---//
+/// @brief Scope object that registers a callback to be invoked as soon as a stop is requested on a task (in the style of std::stop_callback)
+/// @details The callback is invoked synchronously from within @ref Task::RequestStop(), or immediately from the constructor
+/// if a stop has already been requested. It is deregistered when the StopCallback is destroyed. The callback must not
+/// destroy its own StopCallback.
+class StopCallback
+{
+public:
+	StopCallback(StopContext in_stopCtx, std::function<void()> in_fn); /// Registers the callback with the stop context's task
+	~StopCallback(); /// Deregisters the callback (if it has not yet been invoked)
+	StopCallback(const StopCallback&) = delete;
+	StopCallback& operator=(const StopCallback&) = delete;
+
+private:
+	friend class TaskInternalBase;
+	TaskInternalBase* m_taskInternal = nullptr; // Null once invoked (or once the task has been destroyed)
+	std::function<void()> m_fn;
+	StopCallback* m_prev = nullptr; // Intrusive list links (avoids allocating on registration)
+	StopCallback* m_next = nullptr;
+};
+
 //--- GetStopContext Awaiter ---//
 /// Awaiter class that immediately (without suspending) yields a stop context
 struct GetStopContext
@@ -119,9 +164,571 @@ struct GetStopContext
 
 /// @} end of addtogroup Awaiters
 
+/// @addtogroup Time
+/// @{
+
+//--- Time Conversion ---//
+/// Converts seconds to task time (identity, unless SQUID_TIME_TICKS is set)
+constexpr tTaskTime TaskTimeFromSeconds(double in_seconds)
+{
+#if SQUID_TIME_TICKS
+	return (tTaskTime)(in_seconds * (double)SQUID_TIME_TICKS + (in_seconds < 0.0 ? -0.5 : 0.5)); // Round to the nearest tick
+#else
+	return (tTaskTime)in_seconds;
+#endif //SQUID_TIME_TICKS
+}
+
+/// Converts task time to seconds (identity, unless SQUID_TIME_TICKS is set)
+constexpr double TaskTimeToSeconds(tTaskTime in_time)
+{
+#if SQUID_TIME_TICKS
+	return (double)in_time / (double)SQUID_TIME_TICKS;
+#else
+	return (double)in_time;
+#endif //SQUID_TIME_TICKS
+}
+
+#if SQUID_TIME_TICKS
+/// @private Enables the illegal floating-point overloads of functions that take task time (which would otherwise
+/// silently convert seconds to ticks)
+template <typename tSeconds>
+using tIfFloatSeconds = std::enable_if_t<std::is_floating_point<tSeconds>::value, int>;
+#define SQUID_FLOAT_SECONDS_ERROR "Task time is measured in integer ticks when SQUID_TIME_TICKS is set (convert seconds with TaskTimeFromSeconds())"
+#endif //SQUID_TIME_TICKS
+
+//--- TimeStream ---//
+/// @brief Time-stream whose time is sampled from a source function once per update, and cached in between
+/// @details Sampling a time function (e.g. a clock, or a game's time accessor) for every waiting task on every update is
+/// wasteful, and can make tasks resumed during the same update observe different times. A TimeStream instead samples its
+/// source once per call to Snapshot(). Registering it with a @ref TaskManager (see @ref TaskManager::AddTimeStream())
+/// snapshots it at the start of each update.
+/// 
+/// Each TimeStream owns a queue of the timers created from it (e.g. by WaitSeconds(seconds, timeStream)), ordered by
+/// deadline. Each snapshot only visits the timers that have expired since the previous snapshot, and checking whether a
+/// timer has expired is a plain flag check. The stream must outlive any awaiters using it.
+class TaskTimer;
+class TimeStream
+{
+public:
+	template <typename tTimeFn>
+	TimeStream(tTimeFn in_sourceTimeFn) /// Constructor (takes an initial snapshot of the source time function)
+		: m_sourceTimeFn(in_sourceTimeFn)
+		, m_time(in_sourceTimeFn())
+	{
+	}
+	virtual ~TimeStream() /// Destructor
+	{
+		SQUID_NOTHROW_CHECK(m_timerQueue.empty(), "TimeStream destroyed while timers are still waiting on it");
+	}
+	TimeStream(const TimeStream&) = delete; // Timers refer to the stream by address
+	TimeStream& operator=(const TimeStream&) = delete;
+
+	virtual void Snapshot() /// Samples the source time function (and expires any timers whose deadlines have passed)
+	{
+		m_time = m_sourceTimeFn();
+		ExpireTimers();
+	}
+	virtual bool IsPaused() const /// Returns whether time in this stream is paused
+	{
+		return false;
+	}
+	virtual float GetTimeScale() const /// Returns the rate at which this stream advances relative to its source time function
+	{
+		return 1.0f;
+	}
+	virtual const TimeStream* GetParentStream() const /// Returns the time-stream this stream's source time function reads from (if known)
+	{
+		return nullptr;
+	}
+	tTaskTime GetTime() const /// Returns the time as of the last snapshot
+	{
+		return m_time;
+	}
+	auto GetTimeFn() const /// Returns a time function that reads the cached time (for use with any time-sensitive awaiter)
+	{
+		return [this] { return m_time; };
+	}
+	virtual size_t GetNumTimers() const /// Returns the number of timers waiting in this stream
+	{
+		return m_timerQueue.size();
+	}
+	virtual std::optional<tTaskTime> GetNextDeadline() const; /// Returns the earliest deadline of the timers waiting in this stream (if any)
+
+protected:
+	void ExpireTimers(); // Flags and dequeues every timer whose deadline has passed
+
+	std::function<tTaskTime()> m_sourceTimeFn;
+	tTaskTime m_time = 0;
+
+private:
+	friend class TaskTimer;
+	virtual void AddTimer(TaskTimer* in_timer) const; // Timer queue operations (the queue is mutable, as timers only hold const streams)
+	virtual void RemoveTimer(TaskTimer* in_timer) const;
+	virtual bool IsTimerExpired(const TaskTimer& in_timer) const;
+	void SiftUp(size_t in_idx) const;
+	void SiftDown(size_t in_idx) const;
+	void SwapTimers(size_t in_idxA, size_t in_idxB) const;
+
+	mutable std::vector<TaskTimer*> m_timerQueue; // Binary min-heap of timers, ordered by deadline
+};
+
+//--- Task Timer ---//
+/// @brief Timer registration used by time-sensitive awaiters (e.g. WaitSeconds())
+/// @details While alive, a TaskTimer is registered with the outermost task that was being resumed when it was constructed
+/// (usually a task run by a @ref TaskManager). This lets the scheduler inspect a task's pending deadlines, and shift them
+/// while the task is paused (see @ref TaskManager::PauseTaskGroup()). A paused timer never expires.
+/// 
+/// A task can co_await a TaskTimer to wait until it expires. Unlike awaiting an equivalent predicate, this lets the
+/// scheduler know exactly when the task will next be ready (see @ref TaskManager::GetNextWakeTime()).
+class TaskTimer
+{
+public:
+	template <typename tTimeFn>
+	TaskTimer(tTaskTime in_duration, tTimeFn in_timeFn) /// Starts a timer of a given duration in a given time-stream
+		: m_timeFn(in_timeFn)
+		, m_startTime(in_timeFn())
+		, m_duration(in_duration)
+	{
+		Register();
+	}
+	TaskTimer(tTaskTime in_duration, const TimeStream& in_timeStream) /// Starts a timer of a given duration in a cached time-stream
+		: m_timeStream(&in_timeStream)
+		, m_startTime(in_timeStream.m_time)
+		, m_duration(in_duration)
+	{
+		m_timeStream->AddTimer(this);
+		Register(); // (Dequeues the timer again if it starts paused)
+	}
+#if SQUID_TIME_TICKS
+	template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename tTimeArg>
+	TaskTimer(tSeconds in_duration, const tTimeArg& in_timeArg) /// @private Illegal floating-point implementation
+	{
+		static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+	}
+#endif //SQUID_TIME_TICKS
+	~TaskTimer() /// Deregisters the timer
+	{
+		if(m_timeStream)
+		{
+			m_timeStream->RemoveTimer(this);
+		}
+		Deregister();
+	}
+	TaskTimer(const TaskTimer&) = delete;
+	TaskTimer& operator=(const TaskTimer&) = delete;
+
+	bool IsExpired() const /// Returns whether the timer's duration has elapsed (always false while paused)
+	{
+		return !IsPaused() && (m_timeStream ? m_timeStream->IsTimerExpired(*this) : GetElapsedTime() >= m_duration);
+	}
+	bool IsPaused() const /// Returns whether the timer (or its time-stream) is paused
+	{
+		return m_pauseTime.has_value() || (m_timeStream && m_timeStream->IsPaused());
+	}
+	tTaskTime GetElapsedTime() const /// Returns the (unpaused) time elapsed since the timer started
+	{
+		return (m_pauseTime ? m_pauseTime.value() : GetCurrentTime()) - m_startTime;
+	}
+	tTaskTime GetRemainingTime() const /// Returns the time remaining until the timer expires (negative once overdue)
+	{
+		return m_duration - GetElapsedTime();
+	}
+	tTaskTime GetRemainingSourceTime() const /// Returns the remaining time, measured in the source time of the timer's time-stream (or of its root parent stream)
+	{
+		double timeScale = 1.0;
+		for(const TimeStream* timeStream = m_timeStream; timeStream; timeStream = timeStream->GetParentStream())
+		{
+			timeScale *= timeStream->GetTimeScale();
+		}
+		return timeScale == 1.0 ? GetRemainingTime() : (tTaskTime)(GetRemainingTime() / timeScale);
+	}
+	tTaskTime GetDuration() const /// Returns the duration of the timer
+	{
+		return m_duration;
+	}
+
+private:
+	friend class TaskInternalBase;
+	friend class TimeStream;
+	friend class PolledTimeStream;
+	void Register();
+	void Deregister();
+	tTaskTime GetCurrentTime() const // Returns the current time in the timer's time-stream
+	{
+		return m_timeStream ? m_timeStream->m_time : m_timeFn();
+	}
+	tTaskTime GetDeadline() const // Returns the (unpaused) time at which the timer expires
+	{
+		return m_startTime + m_duration;
+	}
+	void Pause() // Stops the timer from advancing
+	{
+		if(!m_pauseTime)
+		{
+			m_pauseTime = GetCurrentTime();
+			if(m_timeStream)
+			{
+				m_timeStream->RemoveTimer(this);
+			}
+		}
+	}
+	void Unpause() // Shifts the timer's deadline forward by the time spent paused
+	{
+		if(m_pauseTime)
+		{
+			m_startTime += GetCurrentTime() - m_pauseTime.value();
+			m_pauseTime.reset();
+			if(m_timeStream && !m_isDequeued)
+			{
+				m_timeStream->AddTimer(this);
+			}
+		}
+	}
+
+	std::function<tTaskTime()> m_timeFn;
+	const TimeStream* m_timeStream = nullptr; // Set for timers in a TimeStream (which reads its cached time, and queues the timer)
+	tTaskTime m_startTime = 0;
+	tTaskTime m_duration = 0;
+	std::optional<tTaskTime> m_pauseTime; // Set while paused
+	size_t m_queueIdx = SIZE_MAX; // Index in the time-stream's timer queue or arrays (SIZE_MAX if not queued)
+	bool m_isDequeued = false; // Set once the time-stream has dequeued the timer after its deadline passed
+	TaskInternalBase* m_taskInternal = nullptr; // Task this timer is registered with
+	TaskTimer* m_prev = nullptr; // Intrusive list links (avoids allocating on registration)
+	TaskTimer* m_next = nullptr;
+};
+
+//--- PolledTimeStream ---//
+/// @brief Time-stream whose timers are re-evaluated against the current time on every snapshot
+/// @details A @ref TimeStream dequeues each timer once its deadline has passed, which assumes that time only moves
+/// forward. Time functions that can jump backwards (e.g. a scrubbable replay or cutscene time) need their timers to be
+/// polled instead, i.e. re-checked against the current time on every update. A PolledTimeStream keeps the start times
+/// and durations of its timers in contiguous arrays, and each snapshot evaluates all of them in a single (SIMD, where
+/// available) pass that produces a bitmask of expired timers. Checking whether a timer has expired is then a single bit
+/// test, instead of a call through the time function for each waiting task.
+/// 
+/// Polled time-streams are usually created by (and snapshotted by) a task manager (see @ref TaskManager::AddPolledTimeStream()).
+class PolledTimeStream : public TimeStream
+{
+public:
+	template <typename tTimeFn>
+	PolledTimeStream(tTimeFn in_sourceTimeFn) /// Constructor (takes an initial snapshot of the source time function)
+		: TimeStream(in_sourceTimeFn)
+	{
+	}
+	~PolledTimeStream() /// Destructor
+	{
+		SQUID_NOTHROW_CHECK(m_timers.empty(), "PolledTimeStream destroyed while timers are still waiting on it");
+	}
+
+	void Snapshot() override /// Samples the source time function, and re-evaluates every timer against it
+	{
+		m_time = m_sourceTimeFn();
+		EvaluateTimers();
+	}
+	size_t GetNumTimers() const override /// Returns the number of timers waiting in this stream
+	{
+		return m_timers.size();
+	}
+	std::optional<tTaskTime> GetNextDeadline() const override /// Returns the earliest deadline of the timers waiting in this stream (if any)
+	{
+		std::optional<tTaskTime> nextDeadline;
+		for(size_t i = 0; i < m_timers.size(); ++i)
+		{
+			tTaskTime deadline = m_startTimes[i] + m_durations[i];
+			nextDeadline = nextDeadline && nextDeadline.value() < deadline ? nextDeadline : deadline;
+		}
+		return nextDeadline;
+	}
+	size_t GetNumExpiredTimers() const /// Returns the number of timers that were expired as of the last snapshot
+	{
+		size_t numExpired = 0;
+		for(uint64_t maskWord : m_expiredMask)
+		{
+			for(; maskWord; maskWord &= maskWord - 1)
+			{
+				++numExpired;
+			}
+		}
+		return numExpired;
+	}
+
+private:
+	void AddTimer(TaskTimer* in_timer) const override
+	{
+		size_t idx = m_timers.size();
+		in_timer->m_queueIdx = idx;
+		m_timers.push_back(in_timer);
+		m_startTimes.push_back(in_timer->m_startTime);
+		m_durations.push_back(in_timer->m_duration);
+		if(m_expiredMask.size() * 64 <= idx)
+		{
+			m_expiredMask.push_back(0);
+		}
+		SetExpiredBit(idx, m_time - in_timer->m_startTime >= in_timer->m_duration);
+	}
+	void RemoveTimer(TaskTimer* in_timer) const override
+	{
+		size_t idx = in_timer->m_queueIdx;
+		if(idx == SIZE_MAX)
+		{
+			return;
+		}
+
+		// Swap-remove the timer (moving the last timer into its slot)
+		size_t lastIdx = m_timers.size() - 1;
+		if(idx != lastIdx)
+		{
+			m_timers[idx] = m_timers[lastIdx];
+			m_timers[idx]->m_queueIdx = idx;
+			m_startTimes[idx] = m_startTimes[lastIdx];
+			m_durations[idx] = m_durations[lastIdx];
+			SetExpiredBit(idx, GetExpiredBit(lastIdx));
+		}
+		SetExpiredBit(lastIdx, false); // Bits past the last timer are always clear
+		m_timers.pop_back();
+		m_startTimes.pop_back();
+		m_durations.pop_back();
+		m_expiredMask.resize((m_timers.size() + 63) / 64);
+		in_timer->m_queueIdx = SIZE_MAX;
+	}
+	bool IsTimerExpired(const TaskTimer& in_timer) const override
+	{
+		return in_timer.m_queueIdx != SIZE_MAX && GetExpiredBit(in_timer.m_queueIdx);
+	}
+	void EvaluateTimers()
+	{
+		size_t numTimers = m_timers.size();
+		for(size_t wordIdx = 0; wordIdx < m_expiredMask.size(); ++wordIdx)
+		{
+			size_t firstIdx = wordIdx * 64;
+			size_t count = std::min<size_t>(numTimers - firstIdx, 64);
+			m_expiredMask[wordIdx] = EvaluateExpiredMask(m_time, m_startTimes.data() + firstIdx, m_durations.data() + firstIdx, count);
+		}
+	}
+	static uint64_t EvaluateExpiredMask(tTaskTime in_time, const tTaskTime* in_startTimes, const tTaskTime* in_durations, size_t in_count)
+	{
+		// Sets bit i if (time - start[i]) >= duration[i], for up to 64 timers
+		uint64_t mask = 0;
+		size_t i = 0;
+#if SQUID_HAS_SSE2 && !SQUID_TIME_TICKS
+#if SQUID_ENABLE_DOUBLE_PRECISION_TIME
+		__m128d time = _mm_set1_pd(in_time);
+		for(; i + 2 <= in_count; i += 2)
+		{
+			__m128d elapsed = _mm_sub_pd(time, _mm_loadu_pd(in_startTimes + i));
+			mask |= (uint64_t)_mm_movemask_pd(_mm_cmpge_pd(elapsed, _mm_loadu_pd(in_durations + i))) << i;
+		}
+#else
+		__m128 time = _mm_set1_ps(in_time);
+		for(; i + 4 <= in_count; i += 4)
+		{
+			__m128 elapsed = _mm_sub_ps(time, _mm_loadu_ps(in_startTimes + i));
+			mask |= (uint64_t)_mm_movemask_ps(_mm_cmpge_ps(elapsed, _mm_loadu_ps(in_durations + i))) << i;
+		}
+#endif //SQUID_ENABLE_DOUBLE_PRECISION_TIME
+#endif //SQUID_HAS_SSE2
+		for(; i < in_count; ++i) // Remainder (or all timers, without SSE2 or with integer ticks)
+		{
+			mask |= (uint64_t)(in_time - in_startTimes[i] >= in_durations[i]) << i;
+		}
+		return mask;
+	}
+	bool GetExpiredBit(size_t in_idx) const
+	{
+		return (m_expiredMask[in_idx / 64] >> (in_idx % 64)) & 1;
+	}
+	void SetExpiredBit(size_t in_idx, bool in_isExpired) const
+	{
+		uint64_t bit = uint64_t(1) << (in_idx % 64);
+		m_expiredMask[in_idx / 64] = in_isExpired ? (m_expiredMask[in_idx / 64] | bit) : (m_expiredMask[in_idx / 64] & ~bit);
+	}
+
+	mutable std::vector<TaskTimer*> m_timers; // Timers waiting in this stream (mutable, as timers only hold const streams)
+	mutable std::vector<tTaskTime> m_startTimes; // Start time of each timer (parallel to m_timers)
+	mutable std::vector<tTaskTime> m_durations; // Duration of each timer (parallel to m_timers)
+	mutable std::vector<uint64_t> m_expiredMask; // Bit per timer, set if the timer was expired as of the last evaluation
+};
+
+//--- Task Wake Time ---//
+/// Estimate of when a suspended task will next be ready to resume (see @ref TaskManager::GetNextWakeTime())
+struct TaskWakeTime
+{
+	enum class eType /// Kinds of wake time (in order of precedence)
+	{
+		Now, ///< Ready to resume now
+		Unknown, ///< Waiting on a predicate (may become ready at any time)
+		Timer, ///< Waiting on a timer (ready once timeRemaining has elapsed)
+		Never, ///< Waiting forever (or nothing to wait on)
+	};
+	eType type = eType::Never; ///< Kind of wake time
+	std::optional<tTaskTime> timeRemaining; ///< Time remaining until the earliest known timer deadline (if any)
+
+	/// Returns the earlier of two wake times
+	static TaskWakeTime Earliest(const TaskWakeTime& in_lhs, const TaskWakeTime& in_rhs)
+	{
+		TaskWakeTime earliest;
+		earliest.type = std::min(in_lhs.type, in_rhs.type);
+		earliest.timeRemaining = in_lhs.timeRemaining ? in_lhs.timeRemaining : in_rhs.timeRemaining;
+		if(in_lhs.timeRemaining && in_rhs.timeRemaining)
+		{
+			earliest.timeRemaining = std::min(in_lhs.timeRemaining.value(), in_rhs.timeRemaining.value());
+		}
+		return earliest;
+	}
+};
+
+/// @} end of addtogroup Time
+
 //--- Internal Implementation Header ---//
 #include "Private/TaskPrivate.h" // Internal use only! Do not move or include elsewhere!
 
+//--- Stop Callback Implementation ---//
+inline StopCallback::StopCallback(StopContext in_stopCtx, std::function<void()> in_fn)
+	: m_fn(std::move(in_fn))
+{
+	SQUID_RUNTIME_CHECK(in_stopCtx.m_taskInternal, "Cannot register a stop callback with an invalid stop context");
+	in_stopCtx.m_taskInternal->AddStopCallback(this);
+}
+inline StopCallback::~StopCallback()
+{
+	if(m_taskInternal)
+	{
+		m_taskInternal->RemoveStopCallback(this);
+	}
+}
+#if SQUID_HAS_STOP_TOKEN
+inline std::stop_token StopContext::GetStopToken() const
+{
+	return m_taskInternal->GetStopToken();
+}
+#endif //SQUID_HAS_STOP_TOKEN
+
+//--- Task Timer Implementation ---//
+inline void TaskTimer::Register()
+{
+	if(TaskInternalBase* rootTask = TaskInternalBase::GetResumingRootTask())
+	{
+		rootTask->AddTimer(this);
+	}
+}
+inline void TaskTimer::Deregister()
+{
+	if(m_taskInternal)
+	{
+		m_taskInternal->RemoveTimer(this);
+	}
+}
+
+//--- TimeStream Implementation ---//
+inline std::optional<tTaskTime> TimeStream::GetNextDeadline() const
+{
+	return m_timerQueue.empty() ? std::optional<tTaskTime>{} : m_timerQueue.front()->GetDeadline();
+}
+inline void TimeStream::ExpireTimers()
+{
+	while(!m_timerQueue.empty() && m_timerQueue.front()->GetDeadline() <= m_time)
+	{
+		TaskTimer* timer = m_timerQueue.front();
+		RemoveTimer(timer);
+		timer->m_isDequeued = true;
+	}
+}
+inline bool TimeStream::IsTimerExpired(const TaskTimer& in_timer) const
+{
+	return in_timer.m_isDequeued;
+}
+inline void TimeStream::AddTimer(TaskTimer* in_timer) const
+{
+	if(in_timer->GetDeadline() <= m_time)
+	{
+		in_timer->m_isDequeued = true; // Already expired
+		return;
+	}
+	in_timer->m_queueIdx = m_timerQueue.size();
+	m_timerQueue.push_back(in_timer);
+	SiftUp(in_timer->m_queueIdx);
+}
+inline void TimeStream::RemoveTimer(TaskTimer* in_timer) const
+{
+	size_t idx = in_timer->m_queueIdx;
+	if(idx == SIZE_MAX)
+	{
+		return;
+	}
+	size_t lastIdx = m_timerQueue.size() - 1;
+	if(idx != lastIdx)
+	{
+		SwapTimers(idx, lastIdx);
+	}
+	m_timerQueue.pop_back();
+	in_timer->m_queueIdx = SIZE_MAX;
+	if(idx != lastIdx)
+	{
+		SiftDown(idx);
+		SiftUp(idx);
+	}
+}
+inline void TimeStream::SiftUp(size_t in_idx) const
+{
+	while(in_idx > 0)
+	{
+		size_t parentIdx = (in_idx - 1) / 2;
+		if(!(m_timerQueue[in_idx]->GetDeadline() < m_timerQueue[parentIdx]->GetDeadline()))
+		{
+			break;
+		}
+		SwapTimers(in_idx, parentIdx);
+		in_idx = parentIdx;
+	}
+}
+inline void TimeStream::SiftDown(size_t in_idx) const
+{
+	while(true)
+	{
+		size_t minIdx = in_idx;
+		for(size_t childIdx = in_idx * 2 + 1; childIdx <= in_idx * 2 + 2 && childIdx < m_timerQueue.size(); ++childIdx)
+		{
+			if(m_timerQueue[childIdx]->GetDeadline() < m_timerQueue[minIdx]->GetDeadline())
+			{
+				minIdx = childIdx;
+			}
+		}
+		if(minIdx == in_idx)
+		{
+			break;
+		}
+		SwapTimers(in_idx, minIdx);
+		in_idx = minIdx;
+	}
+}
+inline void TimeStream::SwapTimers(size_t in_idxA, size_t in_idxB) const
+{
+	std::swap(m_timerQueue[in_idxA], m_timerQueue[in_idxB]);
+	m_timerQueue[in_idxA]->m_queueIdx = in_idxA;
+	m_timerQueue[in_idxB]->m_queueIdx = in_idxB;
+}
+
+#if SQUID_ENABLE_TASK_FRAME_POOL
+//--- Task Frame Pool ---//
+/// @brief Pre-allocate coroutine frames in the calling thread's frame pool (requires SQUID_ENABLE_TASK_FRAME_POOL)
+/// @details Tasks later created on this thread whose frames round up to the same size class (64-byte granularity, up to
+/// 2KB) take their frames from the pool instead of the heap. Frames are returned to the pool of whichever thread destroys them.
+inline void ReserveTaskFrames(size_t in_numFrames, size_t in_frameSize)
+{
+	TaskFramePool::Reserve(in_numFrames, in_frameSize);
+}
+
+/// @brief Returns the coroutine frame size of the task returned by a task factory (requires SQUID_ENABLE_TASK_FRAME_POOL)
+/// @details The factory is called once, and the resulting task is destroyed without ever being resumed. Typical usage is
+/// @c ReserveTaskFrames(10000, GetTaskFrameSize([]{ return EnemyTask({}); })).
+template <typename tTaskFn>
+size_t GetTaskFrameSize(tTaskFn in_taskFn)
+{
+	auto task = in_taskFn();
+	return TaskFramePool::LastFrameSize();
+}
+#endif //SQUID_ENABLE_TASK_FRAME_POOL
+
 /// @addtogroup Tasks
 /// @{
 
@@ -421,7 +1028,7 @@ public:
 	/// Task return value will be bool if wrapped task had void return type, otherwise std::optional<tRet>.
 	auto CancelIfStopRequested() && /// 
 	{
-		return std::move(*this).CancelIf([this] { return IsStopRequested(); });
+		return CancelTaskIfStopRequested(std::move(*this));
 	}
 	auto CancelIf(tTaskCancelFn in_cancelFn) & /// @private Illegal lvalue implementation
 	{
@@ -431,7 +1038,7 @@ public:
 	auto CancelIfStopRequested() & /// @private Illegal lvalue implementation
 	{
 		static_assert(static_false<tRet>::value, "Cannot call CancelIfStopRequested() on an lvalue (try std::move(task).CancelIfStopRequested())");
-		return std::move(*this).CancelIf([this] { return IsStopRequested(); });
+		return CancelTaskIfStopRequested(std::move(*this));
 	}
 
 	// Stop-If Methods
@@ -484,12 +1091,21 @@ public:
 		static_assert(static_false<tRet>::value, "Cannot call StopIf() on an lvalue (try std::move(task).StopIf())");
 		return StopTaskIf(std::move(*this), in_cancelFn, in_timeout, in_timeFn);
 	}
+#if SQUID_TIME_TICKS
+	template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename... tTimeFn>
+	auto StopIf(tTaskCancelFn in_cancelFn, tSeconds in_timeout, tTimeFn... in_timeFn) /// @private Illegal floating-point implementation
+	{
+		static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+		return StopTaskIf(std::move(*this), in_cancelFn);
+	}
+#endif //SQUID_TIME_TICKS
 
 private:
 	/// @cond
 	template <typename, eTaskRef, eTaskResumable, typename> friend struct TaskAwaiterBase;
 	template <typename, eTaskRef, eTaskResumable> friend class Task;
 	friend class TaskInternalBase;
+	friend class TaskManager;
 	/// @endcond
 
 	// Task Internal Storage
@@ -641,6 +1257,44 @@ tTaskTime GetTimeSince(tTaskTime in_t)
 }
 #endif //SQUID_ENABLE_GLOBAL_TIME
 
+//--- VirtualTimeStream ---//
+/// @brief Time-stream that only advances when explicitly told to (e.g. for offline simulations and tests)
+/// @details Pass GetTimeFn() to time-sensitive awaiters, or return GetTime() from GetGlobalTime(). A @ref TaskManager
+/// can fast-forward a virtual time-stream directly to its next timer deadline whenever no task is ready to resume (see
+/// @ref TaskManager::SetFastForwardTimeStream()), so hours of game time can be simulated in seconds.
+class VirtualTimeStream
+{
+public:
+	VirtualTimeStream(tTaskTime in_startTime = 0) /// Constructor
+		: m_time(in_startTime)
+	{
+	}
+	VirtualTimeStream(const VirtualTimeStream&) = delete; // Time functions refer to the stream by address
+	VirtualTimeStream& operator=(const VirtualTimeStream&) = delete;
+
+	tTaskTime GetTime() const /// Returns the current time
+	{
+		return m_time;
+	}
+	auto GetTimeFn() const /// Returns a time function for this time-stream (which must outlive any awaiters using it)
+	{
+		return [this] { return m_time; };
+	}
+	void Advance(tTaskTime in_dt) /// Advances time by a (non-negative) duration
+	{
+		SQUID_RUNTIME_CHECK(in_dt >= 0, "Virtual time cannot move backwards");
+		m_time += in_dt;
+	}
+	void SetTime(tTaskTime in_time) /// Sets the current time (which cannot move backwards)
+	{
+		SQUID_RUNTIME_CHECK(in_time >= m_time, "Virtual time cannot move backwards");
+		m_time = in_time;
+	}
+
+private:
+	tTaskTime m_time = 0;
+};
+
 /// @} end of addtogroup Time
 
 /// @addtogroup Awaiters
@@ -842,31 +1496,36 @@ inline Task<> _WaitWhile(tTaskReadyFn in_readyFn DEBUG_STR) /// @private
 /// Awaiter function that waits forever (only for use in tasks that will be killed externally)
 inline Task<> WaitForever()
 {
-	return _WaitUntil([]() { return false; } MANUAL_DEBUG_STR("WaitForever"));
+	TASK_NAME(__FUNCTION__);
+	co_await SuspendForever{}; // Lets the scheduler know this task will never be ready
 }
 
 /// Awaiter function that waits N seconds in a given time-stream
-template <typename tTimeFn>
+template <typename tTimeFn, typename std::enable_if_t<!std::is_base_of<TimeStream, tTimeFn>::value, int> = 0>
 Task<tTaskTime> WaitSeconds(tTaskTime in_seconds, tTimeFn in_timeFn)
 {
-	auto startTime = in_timeFn();
-	TASK_NAME(__FUNCTION__, [in_timeFn, startTime, in_seconds] { return std::to_string(GetTimeSince(startTime, in_timeFn)) + "/" + std::to_string(in_seconds); });
+	TaskTimer timer(in_seconds, in_timeFn); // Registered timer (so its deadline can be shifted while paused)
+	TASK_NAME(__FUNCTION__, [&timer] { return std::to_string(timer.GetElapsedTime()) + "/" + std::to_string(timer.GetDuration()); });
 
-	auto IsTimerUp = [in_timeFn, startTime, in_seconds] {
-		return GetTimeSince(startTime, in_timeFn) >= in_seconds;
-	};
-	co_await IsTimerUp; // Wait until the timer is up
-	co_return in_timeFn() - startTime - in_seconds;
+	co_await timer; // Wait until the timer is up
+	co_return -timer.GetRemainingTime();
+}
+
+/// Awaiter function that waits N seconds in a cached time-stream (see @ref TimeStream and @ref ScaledTimeStream)
+inline Task<tTaskTime> WaitSeconds(tTaskTime in_seconds, const TimeStream& in_timeStream)
+{
+	TaskTimer timer(in_seconds, in_timeStream);
+	TASK_NAME(__FUNCTION__, [&timer] { return std::to_string(timer.GetElapsedTime()) + "/" + std::to_string(timer.GetDuration()); });
+
+	co_await timer; // Wait until the timer is up
+	co_return -timer.GetRemainingTime();
 }
 
 /// Awaiter function that wraps a given task, canceling it after N seconds in a given time-stream. Returns whether it timed-out or not.
 template <typename tRet, typename tTimeFn>
 auto Timeout(Task<tRet>&& in_task, tTaskTime in_seconds, tTimeFn in_timeFn)
 {
-	auto IsTimerUp = [in_timeFn, startTime = in_timeFn(), in_seconds]{
-		return GetTimeSince(startTime, in_timeFn) >= in_seconds;
-	};
-	return CancelTaskIf(std::move(in_task), IsTimerUp);
+	return TimeoutImpl(std::move(in_task), in_seconds, in_timeFn);
 }
 
 /// Awaiter function that calls a given function after N seconds in a given time-stream
@@ -921,6 +1580,27 @@ static Task<> DelayCall(tTaskTime in_delaySeconds, tFn in_fn) /// @private Illeg
 }
 #endif //SQUID_ENABLE_GLOBAL_TIME
 
+#if SQUID_TIME_TICKS
+template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename... tTimeArg>
+Task<tTaskTime> WaitSeconds(tSeconds in_seconds, const tTimeArg&... in_timeArg) /// @private Illegal floating-point implementation
+{
+	static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+	return Task<tTaskTime>{};
+}
+template <typename tRet, typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename... tTimeFn>
+auto Timeout(Task<tRet>&& in_task, tSeconds in_seconds, tTimeFn... in_timeFn) /// @private Illegal floating-point implementation
+{
+	static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+	return Task<>{};
+}
+template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename tFn, typename... tTimeFn>
+Task<> DelayCall(tSeconds in_delaySeconds, tFn in_fn, tTimeFn... in_timeFn) /// @private Illegal floating-point implementation
+{
+	static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+	return Task<>{};
+}
+#endif //SQUID_TIME_TICKS
+
 //--- Cancel-If Implementation ---//
 template <typename tRet>
 Task<std::optional<tRet>> CancelIfImpl(Task<tRet> in_task, tTaskCancelFn in_cancelFn) /// @private
@@ -940,7 +1620,7 @@ Task<std::optional<tRet>> CancelIfImpl(Task<tRet> in_task, tTaskCancelFn in_canc
 		{
 			co_return in_task.TakeReturnValue();
 		}
-		co_await Suspend();
+		co_await WaitForInnerTask(in_task, in_cancelFn); // Wait until the task (or the cancel function) is ready
 	}
 	co_return{};
 }
@@ -961,7 +1641,7 @@ inline Task<bool> CancelIfImpl(Task<> in_task, tTaskCancelFn in_cancelFn) /// @p
 		{
 			co_return true;
 		}
-		co_await Suspend();
+		co_await WaitForInnerTask(in_task, in_cancelFn); // Wait until the task (or the cancel function) is ready
 	}
 	co_return false;
 }
@@ -972,6 +1652,107 @@ auto CancelTaskIf(Task<tRet, RefType, Resumable>&& in_task, tTaskCancelFn in_can
 	return CancelIfImpl(std::move(in_task), in_cancelFn);
 }
 
+//--- Timeout Implementation ---//
+template <typename tRet, typename tTimeFn>
+Task<std::optional<tRet>> TimeoutImpl(Task<tRet> in_task, tTaskTime in_seconds, tTimeFn in_timeFn) /// @private
+{
+	TaskTimer timer(in_seconds, in_timeFn); // Registered timer (so the scheduler knows when the timeout expires)
+	TASK_NAME("Timeout", [taskHandle = TaskHandle<tRet>(in_task)]{ return taskHandle.GetDebugStack(); });
+
+	co_await AddStopTask(in_task); // Setup stop-request propagation
+
+	while(true)
+	{
+		if(timer.IsExpired())
+		{
+			co_return{};
+		}
+		auto taskStatus = in_task.Resume();
+		if(taskStatus == eTaskStatus::Done)
+		{
+			co_return in_task.TakeReturnValue();
+		}
+		co_await WaitForInnerTask(in_task, timer); // Wait until the task is ready (or the timer expires)
+	}
+	co_return{};
+}
+template <typename tTimeFn>
+Task<bool> TimeoutImpl(Task<> in_task, tTaskTime in_seconds, tTimeFn in_timeFn) /// @private
+{
+	TaskTimer timer(in_seconds, in_timeFn); // Registered timer (so the scheduler knows when the timeout expires)
+	TASK_NAME("Timeout", [taskHandle = TaskHandle<>(in_task)]{ return taskHandle.GetDebugStack(); });
+
+	co_await AddStopTask(in_task); // Setup stop-request propagation
+
+	while(true)
+	{
+		if(timer.IsExpired())
+		{
+			co_return false;
+		}
+		auto taskStatus = in_task.Resume();
+		if(taskStatus == eTaskStatus::Done)
+		{
+			co_return true;
+		}
+		co_await WaitForInnerTask(in_task, timer); // Wait until the task is ready (or the timer expires)
+	}
+	co_return false;
+}
+
+//--- Cancel-If-Stop-Requested Implementation ---//
+template <typename tRet>
+Task<std::optional<tRet>> CancelIfStopRequestedImpl(Task<tRet> in_task) /// @private
+{
+	TASK_NAME("CancelIfStopRequested", [taskHandle = TaskHandle<tRet>(in_task)]{ return taskHandle.GetDebugStack(); });
+
+	co_await AddStopTask(in_task); // Setup stop-request propagation
+
+	// Register a stop callback (instead of polling a cancel function every frame)
+	bool isCanceled = false;
+	auto stopCtx = co_await GetStopContext();
+	StopCallback stopCallback(stopCtx, [&isCanceled] { isCanceled = true; });
+
+	while(!isCanceled)
+	{
+		auto taskStatus = in_task.Resume();
+		if(taskStatus == eTaskStatus::Done)
+		{
+			co_return in_task.TakeReturnValue();
+		}
+		co_await WaitForInnerTask(in_task, ExternalReadyFn{ [&isCanceled] { return isCanceled; } }); // Wait until the task is ready (or a stop is requested)
+	}
+	co_return{};
+}
+inline Task<bool> CancelIfStopRequestedImpl(Task<> in_task) /// @private
+{
+	TASK_NAME("CancelIfStopRequested", [taskHandle = TaskHandle<>(in_task)]{ return taskHandle.GetDebugStack(); });
+
+	co_await AddStopTask(in_task); // Setup stop-request propagation
+
+	// Register a stop callback (instead of polling a cancel function every frame)
+	bool isCanceled = false;
+	auto stopCtx = co_await GetStopContext();
+	StopCallback stopCallback(stopCtx, [&isCanceled] { isCanceled = true; });
+
+	while(!isCanceled)
+	{
+		auto taskStatus = in_task.Resume();
+		if(taskStatus == eTaskStatus::Done)
+		{
+			co_return true;
+		}
+		co_await WaitForInnerTask(in_task, ExternalReadyFn{ [&isCanceled] { return isCanceled; } }); // Wait until the task is ready (or a stop is requested)
+	}
+	co_return false;
+}
+template <typename tRet, eTaskRef RefType, eTaskResumable Resumable>
+auto CancelTaskIfStopRequested(Task<tRet, RefType, Resumable>&& in_task) /// @private
+{
+	static_assert(RefType == eTaskRef::Strong && Resumable == eTaskResumable::Yes, "Cannot call CancelIfStopRequested() on WeakTask, TaskHandle or WeakTaskHandle");
+	return CancelIfStopRequestedImpl(std::move(in_task));
+}
+
 //--- Stop-If Implementation ---//
 template <typename tRet, typename tTimeFn>
 Task<std::optional<tRet>> StopIfImpl(Task<tRet> in_task, tTaskCancelFn in_cancelFn, std::optional<tTaskTime> in_timeout, tTimeFn in_timeFn) /// @private
@@ -997,7 +1778,7 @@ Task<std::optional<tRet>> StopIfImpl(Task<tRet> in_task, tTaskCancelFn in_cancel
 		{
 			co_return in_task.TakeReturnValue();
 		}
-		co_await Suspend();
+		co_await WaitForInnerTask(in_task, in_task.IsStopRequested() ? tTaskCancelFn{} : in_cancelFn); // Wait until the task (or the stop function) is ready
 	}
 }
 template <typename tTimeFn>
@@ -1024,7 +1805,7 @@ Task<bool> StopIfImpl(Task<> in_task, tTaskCancelFn in_cancelFn, std::optional<t
 		{
 			co_return true;
 		}
-		co_await Suspend();
+		co_await WaitForInnerTask(in_task, in_task.IsStopRequested() ? tTaskCancelFn{} : in_cancelFn); // Wait until the task (or the stop function) is ready
 	}
 	co_return false;
 }
@@ -0,0 +1,292 @@
+#pragma once
+
+/// @defgroup TaskDataStream Task Data Stream
+/// @brief Memory-mapped data files whose records can be streamed to a task in batches across frames.
+/// @{
+///
+/// Loading a large data file line-by-line at startup stalls the first frame, and copies every line into its own
+/// allocation. A @ref MappedFile instead maps a file directly into memory, and a @ref RecordStream splits the mapped
+/// data into records (lines, by default) that are exposed as std::string_views into the mapping. Each call to
+/// RecordStream::NextBatch() yields the next batch of records, waiting one frame between batches, so that a loading task
+/// spreads its work across frames:
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+///
+/// MappedFile m_wordsFile; // Must outlive any string_views into its data
+/// std::vector<std::string_view> m_words;
+///
+/// Task<> LoadWordsTask()
+/// {
+/// 	m_wordsFile.Open("words.txt");
+/// 	RecordStream stream(m_wordsFile.GetData());
+/// 	while(co_await stream.NextBatch()) // Yields one batch (of up to 256 lines) per frame
+/// 	{
+/// 		for(std::string_view word : stream.GetBatch())
+/// 		{
+/// 			m_words.push_back(word);
+/// 		}
+/// 	}
+/// }
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Mapping is lazy, so pages of the file are only read from disk as the records on them are first visited. Records
+/// (and string_views derived from them) remain valid until their MappedFile is closed or destroyed. This header requires
+/// C++17 (for std::string_view).
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Task.h"
+
+NAMESPACE_SQUID_BEGIN
+
+//--- MappedFile ---//
+/// Read-only memory mapping of a file
+class MappedFile
+{
+public:
+	MappedFile() = default; /// Default constructor (no file is mapped)
+	explicit MappedFile(const std::string& in_path) /// Constructor (maps the given file)
+	{
+		Open(in_path);
+	}
+	~MappedFile() /// Destructor (unmaps the file)
+	{
+		Close();
+	}
+	MappedFile(MappedFile&& in_other) noexcept /// Move constructor
+	{
+		*this = std::move(in_other);
+	}
+	MappedFile& operator=(MappedFile&& in_other) noexcept /// Move assignment operator
+	{
+		if(this != &in_other)
+		{
+			Close();
+			std::swap(m_data, in_other.m_data);
+			std::swap(m_size, in_other.m_size);
+			std::swap(m_isOpen, in_other.m_isOpen);
+#if defined(_WIN32)
+			std::swap(m_fileHandle, in_other.m_fileHandle);
+			std::swap(m_mappingHandle, in_other.m_mappingHandle);
+#endif
+		}
+		return *this;
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// Maps a file into memory, unmapping any previously-mapped file (returns whether the file was mapped)
+	bool Open(const std::string& in_path)
+	{
+		Close();
+#if defined(_WIN32)
+		m_fileHandle = CreateFileA(in_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if(!GetFileSizeEx(m_fileHandle, &fileSize))
+		{
+			Close();
+			return false;
+		}
+		m_size = (size_t)fileSize.QuadPart;
+		m_isOpen = true;
+		if(m_size > 0) // Empty files cannot be mapped
+		{
+			m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			m_data = m_mappingHandle ? (const char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if(!m_data)
+			{
+				Close();
+				return false;
+			}
+		}
+#else
+		int fd = open(in_path.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd < 0)
+		{
+			return false;
+		}
+		struct stat fileStat;
+		if(fstat(fd, &fileStat) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		m_size = (size_t)fileStat.st_size;
+		if(m_size > 0) // Empty files cannot be mapped
+		{
+			void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(data == MAP_FAILED)
+			{
+				close(fd);
+				m_size = 0;
+				return false;
+			}
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_data = (const char*)data;
+		}
+		close(fd); // The mapping remains valid after the descriptor is closed
+		m_isOpen = true;
+#endif
+		return true;
+	}
+
+	/// Unmaps the file (invalidating any string_views into its data)
+	void Close()
+	{
+#if defined(_WIN32)
+		if(m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if(m_mappingHandle)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+		if(m_fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if(m_data)
+		{
+			munmap((void*)m_data, m_size);
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_isOpen = false;
+	}
+
+	/// Returns whether a file is mapped
+	bool IsOpen() const
+	{
+		return m_isOpen;
+	}
+
+	/// Returns the mapped contents of the file (empty if no file is mapped)
+	std::string_view GetData() const
+	{
+		return m_data ? std::string_view(m_data, m_size) : std::string_view();
+	}
+
+private:
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isOpen = false;
+#if defined(_WIN32)
+	HANDLE m_fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE m_mappingHandle = nullptr;
+#endif
+};
+
+//--- RecordStream ---//
+/// Stream that splits data into delimited records, and yields them to a task in batches across frames
+class RecordStream
+{
+public:
+	/// @brief Constructor
+	/// @details The data must outlive the stream (and any records read from it). Empty records are skipped, and a trailing
+	/// carriage return is stripped from each record (so files with Windows line endings can be read line-by-line).
+	RecordStream(std::string_view in_data, char in_delim = '\n', size_t in_batchSize = 256)
+		: m_data(in_data)
+		, m_delim(in_delim)
+		, m_batchSize(in_batchSize > 0 ? in_batchSize : 1)
+	{
+		m_batch.reserve(m_batchSize);
+	}
+
+	/// @brief Awaiter function that reads the next batch of records into GetBatch() (returns false once the stream is exhausted)
+	/// @details The first batch is read immediately. Each subsequent batch is read after waiting one frame.
+	Task<bool> NextBatch()
+	{
+		TASK_NAME(__FUNCTION__);
+
+		if(m_numBatches > 0 && !IsDone())
+		{
+			co_await Suspend(); // Spread batches across frames
+		}
+		ReadBatch();
+		co_return !m_batch.empty();
+	}
+
+	/// Reads the next batch of records into GetBatch() without waiting (returns false once the stream is exhausted)
+	bool ReadBatch()
+	{
+		m_batch.clear();
+		while(m_batch.size() < m_batchSize && !IsDone())
+		{
+			size_t recordEnd = m_data.find(m_delim, m_pos);
+			if(recordEnd == std::string_view::npos)
+			{
+				recordEnd = m_data.size();
+			}
+			std::string_view record = m_data.substr(m_pos, recordEnd - m_pos);
+			m_pos = recordEnd + 1;
+			if(!record.empty() && record.back() == '\r')
+			{
+				record.remove_suffix(1);
+			}
+			if(!record.empty())
+			{
+				m_batch.push_back(record);
+			}
+		}
+		++m_numBatches;
+		return !m_batch.empty();
+	}
+
+	/// Returns the records in the current batch
+	const std::vector<std::string_view>& GetBatch() const
+	{
+		return m_batch;
+	}
+
+	/// Returns whether every record has been read
+	bool IsDone() const
+	{
+		return m_pos >= m_data.size();
+	}
+
+	/// Returns the fraction of the data that has been read (from 0 to 1)
+	float GetProgress() const
+	{
+		return m_data.empty() || IsDone() ? 1.0f : (float)m_pos / (float)m_data.size();
+	}
+
+private:
+	std::string_view m_data;
+	char m_delim = '\n';
+	size_t m_batchSize = 256;
+	size_t m_pos = 0;
+	size_t m_numBatches = 0;
+	std::vector<std::string_view> m_batch;
+};
+
+NAMESPACE_SQUID_END
+
+///@} end of TaskDataStream group
@@ -0,0 +1,314 @@
+#pragma once
+
+/// @defgroup TaskFileIO Task File I/O
+/// @brief Awaiter functions that read and write files on background worker threads.
+/// @{
+///
+/// File operations block the calling thread, which stalls every task on a @ref TaskManager while a file is being loaded
+/// or saved. A TaskFileIO instance owns a small pool of worker threads that perform file operations in the background,
+/// and offers awaiter functions that suspend a task until its operation has completed.
+///
+/// Each operation is queued as soon as its awaiter function is called (not when the returned task is first resumed), so
+/// several operations can be started up front and then awaited in turn. Waiting tasks are not polled: they are treated
+/// as asleep by @ref TaskManager::GetNextWakeTime(), and the pool calls its wake function (see
+/// @ref TaskFileIO::SetWakeFn()) after each operation completes, e.g. to wake a @ref TaskRunLoop or @ref TaskReactor.
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+///
+/// Task<> LoadLevelTask()
+/// {
+/// 	auto layoutTask = ReadFileAsync("level.txt"); // Both reads start immediately
+/// 	auto spawnsTask = ReadFileAsync("spawns.csv");
+/// 	std::optional<std::string> layout = co_await std::move(layoutTask);
+/// 	std::optional<std::string> spawns = co_await std::move(spawnsTask);
+/// 	if(!layout || !spawns)
+/// 	{
+/// 		co_return; // Failed to open one of the files
+/// 	}
+/// 	...
+/// }
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// Reads are cancelled if their task is destroyed before they start. Destroying the task of a whole-file read that is
+/// already in progress never blocks (the worker finishes the read, and the result is discarded). A chunked read (which
+/// writes into a caller-provided buffer) that is already in progress when its task is destroyed will block the
+/// destroying thread until the chunk has been read, so that the buffer is never written to after the task has been
+/// killed. Writes are never cancelled once queued, so a game can save on exit without awaiting the result.
+///
+/// The worker pool is portable (it uses standard file streams and threads). Awaiter functions must be called from the
+/// thread that runs the awaiting tasks.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Task.h"
+
+NAMESPACE_SQUID_BEGIN
+
+//--- TaskFileIO ---//
+/// Pool of worker threads that performs file operations for awaiting tasks
+class TaskFileIO
+{
+public:
+	TaskFileIO(uint32_t in_numThreads = 2) /// Constructor (starts the worker threads)
+	{
+		for(uint32_t i = 0; i < std::max(in_numThreads, 1u); ++i)
+		{
+			m_workers.emplace_back([this] { WorkerLoop(); });
+		}
+	}
+	~TaskFileIO() /// Destructor (finishes all queued operations, then joins the worker threads)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isShuttingDown = true;
+		}
+		m_workCondition.notify_all();
+		for(auto& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+	TaskFileIO(const TaskFileIO&) = delete;
+	TaskFileIO& operator=(const TaskFileIO&) = delete;
+
+	/// Returns the default pool used by ReadFileAsync(), WriteFileAsync() and ReadFileChunkAsync()
+	static TaskFileIO& GetDefault()
+	{
+		static TaskFileIO s_fileIO;
+		return s_fileIO;
+	}
+
+	/// @brief Sets a function to be called (from a worker thread) each time an operation completes
+	/// @details Typically used to wake a sleeping scheduler, e.g. [&runLoop] { runLoop.Wake(); }
+	void SetWakeFn(std::function<void()> in_wakeFn)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_wakeFn = std::move(in_wakeFn);
+	}
+
+	/// Returns the number of operations that are queued or in progress
+	size_t GetNumPendingOps() const
+	{
+		return m_numPendingOps;
+	}
+
+	/// @brief Awaiter function that reads an entire file (returns an unset optional if the file could not be read)
+	Task<std::optional<std::string>> ReadFile(std::string in_path)
+	{
+		return RunOp<std::optional<std::string>>([path = std::move(in_path)]() -> std::optional<std::string> {
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if(!file.is_open())
+			{
+				return {};
+			}
+			std::string contents;
+			contents.resize((size_t)file.tellg());
+			file.seekg(0);
+			file.read(contents.data(), contents.size());
+			if(!file)
+			{
+				return {};
+			}
+			return contents;
+		}, eCancelMode::BeforeStart);
+	}
+
+	/// @brief Awaiter function that replaces the contents of a file (returns whether the write succeeded)
+	Task<bool> WriteFile(std::string in_path, std::string in_buffer)
+	{
+		return RunOp<bool>([path = std::move(in_path), buffer = std::move(in_buffer)]() -> bool {
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if(!file.is_open())
+			{
+				return false;
+			}
+			file.write(buffer.data(), buffer.size());
+			return (bool)file;
+		}, eCancelMode::Never);
+	}
+
+	/// @brief Awaiter function that reads up to @p in_size bytes from a file, starting at @p in_offset, into a caller-provided buffer
+	/// @details Returns the number of bytes read (0 at the end of the file), or an unset optional if the file could not be
+	/// read. The buffer must remain valid until the returned task has completed or been destroyed.
+	Task<std::optional<size_t>> ReadFileChunk(std::string in_path, uint64_t in_offset, char* out_buffer, size_t in_size)
+	{
+		return RunOp<std::optional<size_t>>([path = std::move(in_path), in_offset, out_buffer, in_size]() -> std::optional<size_t> {
+			std::ifstream file(path, std::ios::binary);
+			if(!file.is_open())
+			{
+				return {};
+			}
+			file.seekg(in_offset);
+			if(!file)
+			{
+				return (size_t)0; // Offset is past the end of the file
+			}
+			file.read(out_buffer, in_size);
+			return (size_t)file.gcount();
+		}, eCancelMode::Blocking);
+	}
+
+private:
+	// How an operation is cancelled when its awaiting task is destroyed before it completes
+	enum class eCancelMode
+	{
+		Never, // Always runs once queued (e.g. writes)
+		BeforeStart, // Skipped if not yet started (an in-progress operation only writes into its own state, so never blocks)
+		Blocking, // Skipped if not yet started, otherwise waits for it to finish (as it writes into a caller-provided buffer)
+	};
+
+	// Operation state (shared between the awaiting task and the worker that performs the operation)
+	template <typename tRet>
+	struct OpState
+	{
+		std::mutex mutex; // Held by the worker while a blocking-cancel operation is in progress
+		std::atomic<bool> isDone = false;
+		std::atomic<bool> isCancelled = false;
+		tRet result = {};
+	};
+
+	// Cancels an operation when destroyed (lives in the coroutine frame of the awaiting task)
+	template <typename tRet>
+	struct OpCanceller
+	{
+		OpCanceller(std::shared_ptr<OpState<tRet>> in_op, bool in_isBlocking)
+			: op(std::move(in_op))
+			, isBlocking(in_isBlocking)
+		{
+		}
+		OpCanceller(OpCanceller&& in_other) noexcept = default;
+		~OpCanceller()
+		{
+			if(op)
+			{
+				std::unique_lock<std::mutex> lock(op->mutex, std::defer_lock);
+				if(isBlocking)
+				{
+					lock.lock(); // Waits for an in-progress operation to finish
+				}
+				op->isCancelled = true;
+			}
+		}
+		std::shared_ptr<OpState<tRet>> op;
+		bool isBlocking = false;
+	};
+
+	template <typename tRet, typename tOpFn>
+	Task<tRet> RunOp(tOpFn in_opFn, eCancelMode in_cancelMode)
+	{
+		// Queue the operation immediately
+		auto op = std::make_shared<OpState<tRet>>();
+		bool isBlocking = in_cancelMode == eCancelMode::Blocking;
+		Enqueue([op, opFn = std::move(in_opFn), isBlocking] {
+			std::unique_lock<std::mutex> lock(op->mutex, std::defer_lock);
+			if(isBlocking)
+			{
+				lock.lock();
+			}
+			if(!op->isCancelled)
+			{
+				op->result = opFn();
+			}
+			op->isDone = true;
+		});
+
+		// Wait for the worker to complete the operation
+		std::optional<OpCanceller<tRet>> canceller;
+		if(in_cancelMode != eCancelMode::Never)
+		{
+			canceller.emplace(op, isBlocking);
+		}
+		return AwaitOp<tRet>(op, std::move(canceller));
+	}
+	template <typename tRet>
+	static Task<tRet> AwaitOp(std::shared_ptr<OpState<tRet>> in_op, std::optional<OpCanceller<tRet>> in_canceller)
+	{
+		TASK_NAME("TaskFileIO::AwaitOp");
+		(void)in_canceller; // Cancels the operation if this task is destroyed before it completes
+		OpState<tRet>* op = in_op.get(); // (Kept alive by in_op)
+		co_await ExternalReadyFn{ [op] { return op->isDone.load(); } };
+		co_return std::move(in_op->result);
+	}
+	void Enqueue(std::function<void()> in_job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(in_job));
+			++m_numPendingOps;
+		}
+		m_workCondition.notify_one();
+	}
+	void WorkerLoop()
+	{
+		while(true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_workCondition.wait(lock, [this] { return m_isShuttingDown || !m_jobs.empty(); });
+				if(m_jobs.empty())
+				{
+					return; // Shutting down (and all queued operations have completed)
+				}
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+			job();
+			std::function<void()> wakeFn;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				--m_numPendingOps;
+				wakeFn = m_wakeFn;
+			}
+			if(wakeFn)
+			{
+				wakeFn();
+			}
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_workCondition;
+	std::deque<std::function<void()>> m_jobs;
+	std::vector<std::thread> m_workers;
+	std::function<void()> m_wakeFn;
+	std::atomic<size_t> m_numPendingOps = 0;
+	bool m_isShuttingDown = false;
+};
+
+//--- File I/O Awaiters ---//
+/// @brief Awaiter function that reads an entire file on a background thread (returns an unset optional on failure)
+inline Task<std::optional<std::string>> ReadFileAsync(std::string in_path, TaskFileIO& in_fileIO = TaskFileIO::GetDefault())
+{
+	return in_fileIO.ReadFile(std::move(in_path));
+}
+
+/// @brief Awaiter function that replaces the contents of a file on a background thread (returns whether the write succeeded)
+inline Task<bool> WriteFileAsync(std::string in_path, std::string in_buffer, TaskFileIO& in_fileIO = TaskFileIO::GetDefault())
+{
+	return in_fileIO.WriteFile(std::move(in_path), std::move(in_buffer));
+}
+
+/// @brief Awaiter function that reads a chunk of a file into a caller-provided buffer on a background thread
+/// @details Returns the number of bytes read (0 at the end of the file), or an unset optional on failure.
+inline Task<std::optional<size_t>> ReadFileChunkAsync(std::string in_path, uint64_t in_offset, char* out_buffer, size_t in_size, TaskFileIO& in_fileIO = TaskFileIO::GetDefault())
+{
+	return in_fileIO.ReadFileChunk(std::move(in_path), in_offset, out_buffer, in_size);
+}
+
+NAMESPACE_SQUID_END
+
+///@} end of TaskFileIO group
@@ -75,13 +75,205 @@
 /// Note that it is sometimes necessary to have multiple TaskManagers within a single actor. For example, if there are
 /// multiple tick functions (such as one for pre-physics updates and one for post-physics updates), then instantiating
 /// a second "post-physics" task manager may be desirable.
+/// 
+/// Task Groups
+/// -----------
+/// A task can optionally be tagged with a @ref tTaskTag when it is run (e.g. an entity id, or a subsystem/zone name hashed
+/// with @ref MakeTaskTag()). All tasks sharing a tag form a task group, which can be stopped, killed, counted, enumerated
+/// or awaited as a unit (e.g. @ref TaskManager::StopTaskGroup()). Group operations only touch the tasks in that group, so
+/// there is no need to keep parallel arrays of task handles or to scan the whole manager to find the tasks of one entity.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// constexpr tTaskTag k_aiTag = MakeTaskTag("AI");
+/// m_taskMgr.RunManaged(ThinkTask(), k_aiTag);
+/// m_taskMgr.RunManaged(PathfindTask(), k_aiTag);
+/// ...
+/// co_await m_taskMgr.StopTaskGroup(k_aiTag); // Gracefully stop all AI tasks, then wait for them to terminate
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// A task group can also be paused with @ref TaskManager::PauseTaskGroup(). Paused tasks are removed from the list of
+/// tasks resumed by @ref TaskManager::Update() (so they cost nothing while paused), and any pending timers they are
+/// waiting on (see @ref TaskTimer) are frozen. When the group is unpaused, its tasks rejoin the update list in their
+/// original order, and their timer deadlines are shifted by the time spent paused.
+/// 
+/// Frame Budgets and Deadlines
+/// ---------------------------
+/// @ref TaskManager::Update() can optionally be given a time budget. Once the budget is spent, the remaining tasks are
+/// skipped for that update, and are the first to be resumed by the next update (so every task still makes progress).
+/// 
+/// Tasks with hard latency requirements (e.g. network replies or audio cues) can be placed in the earliest-deadline-first
+/// (EDF) lane by running them on a task group that has a resume deadline (see @ref TaskManager::SetTaskGroupDeadline()).
+/// Whenever a task in the EDF lane wakes up (i.e. whatever it is awaiting becomes ready), it is given a deadline of its
+/// wake time plus the group's latency. Each update resumes woken EDF tasks nearest-deadline-first, before any other tasks,
+/// and any task that is resumed after its deadline (or that is still waiting when the budget runs out) is reported as a
+/// deadline miss (see @ref TaskManager::SetDeadlineMissFn()).
+/// 
+/// Within a budgeted update, the budget is shared between task groups using weighted fair queuing (untagged tasks share
+/// a single default group). Each group with tasks to resume is allotted a share of the budget in proportion to its weight
+/// (see @ref TaskManager::SetTaskGroupWeight()), and the measured time spent resuming each of its tasks is charged against
+/// that share. Once a group has spent its share, its remaining tasks are only resumed if budget is left over after every
+/// other group has had its turn. A group that overruns its share (e.g. because a single resume took too long) carries
+/// the overrun as debt, which reduces its share during subsequent updates.
+/// 
+/// Update Intervals
+/// ----------------
+/// Tasks that do not need to be resumed every update (e.g. the tasks of distant or low-importance entities) can be given
+/// an update interval of N updates or T seconds (see @ref TaskUpdateInterval), either per task group
+/// (@ref TaskManager::SetTaskGroupUpdateInterval()) or per task (@ref TaskManager::SetTaskUpdateInterval()). Such tasks
+/// are skipped by @ref TaskManager::Update() between ticks. Staggered intervals spread the ticks of tasks sharing an
+/// interval across updates, so they do not all resume during the same update. A skipped task is still resumed as soon as
+/// any timer it is waiting on (see @ref TaskTimer) expires, so time awaiters such as WaitSeconds() keep exact deadlines.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// constexpr tTaskTag k_netTag = MakeTaskTag("Net");
+/// m_taskMgr.SetTaskGroupDeadline(k_netTag, std::chrono::milliseconds(2)); // Replies must be handled within 2ms of arriving
+/// m_taskMgr.RunManaged(HandleReplies(), k_netTag);
+/// ...
+/// m_taskMgr.Update(std::chrono::milliseconds(4)); // Spend at most ~4ms resuming tasks this frame
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// Fast-Forward Simulation
+/// -----------------------
+/// Offline simulations (e.g. balancing or soak tests) can measure their timers in a @ref VirtualTimeStream, and put the
+/// task manager in fast-forward mode (see @ref TaskManager::SetFastForwardTimeStream()). Whenever no task is ready to
+/// resume, each update then jumps the virtual time-stream directly to the next timer deadline, rather than stepping
+/// through the empty frames in between.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// VirtualTimeStream simTime;
+/// m_taskMgr.SetFastForwardTimeStream(&simTime);
+/// m_taskMgr.RunManaged(SpawnWaves(simTime.GetTimeFn()));
+/// while(simTime.GetTime() < 8.0f * 60.0f * 60.0f) // Simulate 8 hours
+/// {
+/// 	m_taskMgr.Update();
+/// }
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "Task.h"
+#if SQUID_ENABLE_FAST_CLOCK
+#include "FastClock.h"
+#endif //SQUID_ENABLE_FAST_CLOCK
 
 NAMESPACE_SQUID_BEGIN
 
+//--- Task Tags ---//
+using tTaskTag = uint64_t; ///< Tag that identifies a task group within a TaskManager
+
+/// Create a task tag from a name string (FNV-1a hash, so it can be evaluated at compile-time)
+constexpr tTaskTag MakeTaskTag(const char* in_name)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for(; *in_name; ++in_name)
+	{
+		hash = (hash ^ (uint8_t)*in_name) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//--- Task Clock ---//
+#if SQUID_ENABLE_FAST_CLOCK
+using tTaskClock = FastClock; ///< Wall clock used to measure update budgets and resume deadlines
+#else
+using tTaskClock = std::chrono::steady_clock; ///< Wall clock used to measure update budgets and resume deadlines
+#endif //SQUID_ENABLE_FAST_CLOCK
+
+//--- TaskUpdateInterval ---//
+/// Interval at which a TaskManager resumes a task or task group (every N updates, or every T seconds)
+class TaskUpdateInterval
+{
+public:
+	/// Resume every N updates (optionally staggered so tasks sharing the interval tick on different updates)
+	static TaskUpdateInterval Updates(uint32_t in_numUpdates, bool in_isStaggered = false)
+	{
+		SQUID_RUNTIME_CHECK(in_numUpdates > 0, "Update interval must be at least 1 update");
+		TaskUpdateInterval interval;
+		interval.m_numUpdates = in_numUpdates;
+		interval.m_isStaggered = in_isStaggered;
+		return interval;
+	}
+
+	/// Resume every T seconds in a given time-stream (optionally staggered so tasks sharing the interval tick at different times)
+	template <typename tTimeFn>
+	static TaskUpdateInterval Seconds(tTaskTime in_seconds, tTimeFn in_timeFn, bool in_isStaggered = false)
+	{
+		TaskUpdateInterval interval;
+		interval.m_seconds = in_seconds;
+		interval.m_timeFn = in_timeFn;
+		interval.m_isStaggered = in_isStaggered;
+		return interval;
+	}
+#if SQUID_ENABLE_GLOBAL_TIME
+	/// Resume every T seconds in the global time-stream (requires SQUID_ENABLE_GLOBAL_TIME)
+	static TaskUpdateInterval Seconds(tTaskTime in_seconds, bool in_isStaggered = false)
+	{
+		return Seconds(in_seconds, GlobalTime(), in_isStaggered);
+	}
+#endif //SQUID_ENABLE_GLOBAL_TIME
+#if SQUID_TIME_TICKS
+	template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0, typename... tArgs>
+	static TaskUpdateInterval Seconds(tSeconds in_seconds, tArgs... in_args) /// @private Illegal floating-point implementation
+	{
+		static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+		return {};
+	}
+#endif //SQUID_TIME_TICKS
+
+private:
+	friend class TaskManager;
+
+	TaskUpdateInterval() = default;
+
+	// Returns whether a task is due to tick (consuming the tick)
+	bool Tick(uint64_t in_updateIdx, uint64_t in_staggerIdx, std::optional<tTaskTime>& io_nextTickTime) const
+	{
+		if(!m_timeFn)
+		{
+			uint64_t phase = m_isStaggered ? in_staggerIdx % m_numUpdates : 0;
+			return (in_updateIdx + phase) % m_numUpdates == 0;
+		}
+		tTaskTime now = m_timeFn();
+		if(!io_nextTickTime)
+		{
+			// Golden-ratio sequence spreads staggered tasks evenly across the interval
+			double phase = m_isStaggered ? std::fmod((double)in_staggerIdx * 0.6180339887498949, 1.0) : 0.0;
+			io_nextTickTime = now + (tTaskTime)(phase * m_seconds);
+		}
+		if(now < io_nextTickTime.value())
+		{
+			return false;
+		}
+		tTaskTime nextTickTime = io_nextTickTime.value() + m_seconds;
+		io_nextTickTime = nextTickTime > now ? nextTickTime : now + m_seconds; // Don't try to catch up on missed ticks
+		return true;
+	}
+
+	uint32_t m_numUpdates = 1;
+	tTaskTime m_seconds = 0;
+	std::function<tTaskTime()> m_timeFn; // Set for intervals measured in seconds
+	bool m_isStaggered = false;
+};
+
 //--- TaskManager ---//
 /// Manager that runs and resumes a collection of tasks.
 class TaskManager
@@ -93,16 +285,16 @@ public:
 	/// @details Run() return a @ref TaskHandle<> that holds a strong reference to the task. If there are ever no
 	/// strong references remaining to an unmanaged task, it will immediately be killed and removed from the manager.
 	template <typename tRet>
-	SQUID_NODISCARD TaskHandle<tRet> Run(Task<tRet>&& in_task)
+	SQUID_NODISCARD TaskHandle<tRet> Run(Task<tRet>&& in_task, std::optional<tTaskTag> in_tag = {})
 	{
 		// Run unmanaged task
 		TaskHandle<tRet> taskHandle = in_task;
 		WeakTask weakTask = std::move(in_task);
-		RunWeakTask(std::move(weakTask));
+		RunWeakTask(std::move(weakTask), in_tag);
 		return taskHandle;
 	}
 	template <typename tRet>
-	SQUID_NODISCARD TaskHandle<tRet> Run(const Task<tRet>& in_task) /// @private Illegal copy implementation
+	SQUID_NODISCARD TaskHandle<tRet> Run(const Task<tRet>& in_task, std::optional<tTaskTag> in_tag = {}) /// @private Illegal copy implementation
 	{
 		static_assert(static_false<tRet>::value, "Cannot run an unmanaged task by copy (try Run(std::move(task)))");
 		return {};
@@ -112,15 +304,15 @@ public:
 	/// @details RunManaged() return a @ref WeakTaskHandle, meaning it can be used to run a "fire-and-forget" background
 	/// task in situations where it is not necessary to observe or control task lifetime.
 	template <typename tRet>
-	WeakTaskHandle RunManaged(Task<tRet>&& in_task)
+	WeakTaskHandle RunManaged(Task<tRet>&& in_task, std::optional<tTaskTag> in_tag = {})
 	{
 		// Run managed task
 		WeakTaskHandle weakTaskHandle = in_task;
-		m_strongRefs.push_back(Run(std::move(in_task)));
+		m_strongRefs.push_back(Run(std::move(in_task), in_tag));
 		return weakTaskHandle;
 	}
 	template <typename tRet>
-	WeakTaskHandle RunManaged(const Task<tRet>& in_task) /// @private Illegal copy implementation
+	WeakTaskHandle RunManaged(const Task<tRet>& in_task, std::optional<tTaskTag> in_tag = {}) /// @private Illegal copy implementation
 	{
 		static_assert(static_false<tRet>::value, "Cannot run a managed task by copy (try RunManaged(std::move(task)))");
 		return {};
@@ -130,51 +322,432 @@ public:
 	/// @details RunWeakTask() runs a WeakTask. The caller is assumed to have already created a strong TaskHandle<> that
 	/// references the WeakTask, thus keeping it from being killed. When the last strong reference to the WeakTask is
 	/// destroyed, the task will immediately be killed and removed from the manager.
-	void RunWeakTask(WeakTask&& in_task)
+	void RunWeakTask(WeakTask&& in_task, std::optional<tTaskTag> in_tag = {})
 	{
-		// Run unmanaged task
-		m_tasks.push_back(std::move(in_task));
+		AddTask(std::move(in_task), in_tag ? &GetOrAddGroup(in_tag.value()) : nullptr);
+	}
+
+	/// @brief Run a range of unmanaged tasks (e.g. a std::vector<Task<>>), moving each task out of the range
+	/// @details Equivalent to calling Run() on each task, but grows the manager's task lists at most once. Returns a
+	/// vector of TaskHandles (in range order).
+	template <typename tRange>
+	SQUID_NODISCARD auto RunMany(tRange&& in_tasks, std::optional<tTaskTag> in_tag = {})
+	{
+		using tTaskHandle = decltype(Run(std::move(*std::begin(in_tasks))));
+		std::vector<tTaskHandle> taskHandles;
+		size_t numTasks = (size_t)std::distance(std::begin(in_tasks), std::end(in_tasks));
+		taskHandles.reserve(numTasks);
+		TaskGroup* group = PrepareToRunMany(numTasks, in_tag);
+		for(auto& task : in_tasks)
+		{
+			taskHandles.push_back(task);
+			AddTask(std::move(task), group);
+		}
+		return taskHandles;
+	}
+
+	/// @brief Run a range of managed tasks (e.g. a std::vector<Task<>>), moving each task out of the range
+	/// @details Equivalent to calling RunManaged() on each task, but grows the manager's task lists at most once, and does
+	/// not return any handles (tasks in a task group can still be accessed using GetTaskGroup()).
+	template <typename tRange>
+	void RunManyManaged(tRange&& in_tasks, std::optional<tTaskTag> in_tag = {})
+	{
+		size_t numTasks = (size_t)std::distance(std::begin(in_tasks), std::end(in_tasks));
+		m_strongRefs.reserve(m_strongRefs.size() + numTasks);
+		TaskGroup* group = PrepareToRunMany(numTasks, in_tag);
+		for(auto& task : in_tasks)
+		{
+			m_strongRefs.push_back(task);
+			AddTask(std::move(task), group);
+		}
 	}
 
-	/// Call Task::Kill() on all tasks (managed + unmanaged)
+	/// @brief Reserve space for a total number of tasks (managed + unmanaged)
+	/// @details Useful before running a large number of tasks at once (e.g. at level load). To also pre-allocate the
+	/// tasks' coroutine frames, see @ref ReserveTaskFrames().
+	void Reserve(size_t in_numTasks)
+	{
+		m_tasks.reserve(in_numTasks);
+		m_strongRefs.reserve(in_numTasks);
+	}
+	/// Call Task::Kill() on all tasks (managed + unmanaged), keeping any task group settings (e.g. paused tags stay paused)
 	void KillAllTasks()
 	{
 		m_tasks.clear(); // Destroying all the weak tasks implicitly destroys all internal tasks
+		m_deadlineTasks.clear();
 
 		// No need to call Kill() on each TaskHandle in m_strongRefs
 		m_strongRefs.clear(); // Handles in the strong refs array only ever point to tasks in the now-cleared m_tasks array
+
+		// Keep groups that have settings (e.g. paused or throttled tags stay so for tasks run later)
+		for(auto iter = m_groups.begin(); iter != m_groups.end();)
+		{
+			TaskGroup& group = iter->second;
+			group.tasks.clear();
+			group.pausedTasks.clear();
+			group.numEntries = 0;
+			group.isDirty = false;
+			iter = HasGroupSettings(group) ? std::next(iter) : m_groups.erase(iter);
+		}
+		m_dirtyGroups.clear();
+		m_unpausedGroups.clear();
 	}
 
 	/// @brief Issue a stop request using @ref Task::RequestStop() on all active tasks (managed and unmanaged)
 	/// @details Returns a new awaiter task that will wait until all those tasks have all terminated.
 	Task<> StopAllTasks()
 	{
-		// Request stop on all tasks
+		// Request stop on all tasks (including paused tasks, which will not terminate until they are unpaused)
 		std::vector<WeakTaskHandle> weakHandles;
-		for(auto& task : m_tasks)
+		for(auto& entry : m_tasks)
 		{
-			task.RequestStop();
-			weakHandles.push_back(task);
+			entry.task.RequestStop();
+			weakHandles.push_back(entry.task);
+		}
+		for(auto& entry : m_deadlineTasks)
+		{
+			entry.task.RequestStop();
+			weakHandles.push_back(entry.task);
+		}
+		for(auto& groupPair : m_groups)
+		{
+			for(auto& entry : groupPair.second.pausedTasks)
+			{
+				entry.task.RequestStop();
+				weakHandles.push_back(entry.task);
+			}
 		}
 
 		// Return a fence task that waits until all stopped tasks are complete
-		return [](std::vector<WeakTaskHandle> in_weakHandles) -> Task<> {
-			TASK_NAME("StopAllTasks() Fence Task");
-			for(const auto& weakHandle : in_weakHandles)
+		return MakeFenceTask(std::move(weakHandles), "StopAllTasks() Fence Task");
+	}
+
+	/// @name Task Groups
+	/// Methods for operating on all tasks that were run with a given @ref tTaskTag (each is O(group size)).
+	/// @{
+
+	/// Call Task::Kill() on all tasks in a task group (managed + unmanaged)
+	void KillTaskGroup(tTaskTag in_tag)
+	{
+		if(TaskGroup* group = FindGroup(in_tag))
+		{
+			// Kill a copy of the handle list, in case a killed task's destructors run tasks on this manager
+			auto tasks = group->tasks;
+			for(auto& task : tasks)
 			{
-				co_await weakHandle; // Wait until task is complete
+				task.Kill();
+			}
+			group->numEntries -= group->pausedTasks.size();
+			group->pausedTasks.clear();
+			MarkGroupDirty(group);
+		}
+	}
+
+	/// @brief Issue a stop request using @ref Task::RequestStop() on all active tasks in a task group
+	/// @details Returns a new awaiter task that will wait until all those tasks have all terminated.
+	Task<> StopTaskGroup(tTaskTag in_tag)
+	{
+		std::vector<WeakTaskHandle> weakHandles = GetTaskGroup(in_tag);
+		for(auto& weakHandle : weakHandles)
+		{
+			weakHandle.RequestStop();
+		}
+		return MakeFenceTask(std::move(weakHandles), "StopTaskGroup() Fence Task");
+	}
+
+	/// Returns a new awaiter task that will wait until all tasks currently in a task group have terminated
+	Task<> WaitForTaskGroup(tTaskTag in_tag) const
+	{
+		return MakeFenceTask(GetTaskGroup(in_tag), "WaitForTaskGroup() Fence Task");
+	}
+
+	/// Returns the number of active tasks in a task group
+	size_t GetTaskGroupCount(tTaskTag in_tag) const
+	{
+		const TaskGroup* group = FindGroup(in_tag);
+		return group ? (size_t)std::count_if(group->tasks.begin(), group->tasks.end(), [](const WeakTaskHandle& in_task) {
+			return !in_task.IsDone();
+		}) : 0;
+	}
+
+	/// Returns handles to all active tasks in a task group (in the order they were run)
+	std::vector<WeakTaskHandle> GetTaskGroup(tTaskTag in_tag) const
+	{
+		std::vector<WeakTaskHandle> weakHandles;
+		if(const TaskGroup* group = FindGroup(in_tag))
+		{
+			weakHandles.reserve(group->tasks.size());
+			for(const auto& task : group->tasks)
+			{
+				if(!task.IsDone())
+				{
+					weakHandles.push_back(task);
+				}
+			}
+		}
+		return weakHandles;
+	}
+
+	/// @brief Pause all tasks in a task group (including tasks that are later run with the same tag)
+	/// @details Paused tasks are not resumed by Update(), and the timers they are waiting on are frozen until the group is unpaused.
+	void PauseTaskGroup(tTaskTag in_tag)
+	{
+		TaskGroup& group = GetOrAddGroup(in_tag);
+		if(!group.isPaused)
+		{
+			group.isPaused = true;
+			for(auto& task : group.tasks)
+			{
+				if(task.IsValid())
+				{
+					task.m_taskInternal->PauseTimers(); // Paused tasks are moved out of the update list during the next Update()
+				}
+			}
+		}
+	}
+
+	/// Unpause all tasks in a task group (shifting their pending timer deadlines by the time spent paused)
+	void UnpauseTaskGroup(tTaskTag in_tag)
+	{
+		TaskGroup* group = FindGroup(in_tag);
+		if(group && group->isPaused)
+		{
+			group->isPaused = false;
+			for(auto& task : group->tasks)
+			{
+				if(task.IsValid())
+				{
+					task.m_taskInternal->UnpauseTimers();
+				}
+			}
+			if(!group->pausedTasks.empty())
+			{
+				m_unpausedGroups.push_back(in_tag); // Paused tasks rejoin the update list at the start of the next Update()
 			}
-		}(std::move(weakHandles));
+			MarkGroupDirty(group); // Allow the group to be pruned if it is now empty
+		}
+	}
+
+	/// Returns whether a task group is paused
+	bool IsTaskGroupPaused(tTaskTag in_tag) const
+	{
+		const TaskGroup* group = FindGroup(in_tag);
+		return group && group->isPaused;
+	}
+
+	/// @brief Set (or clear) the resume deadline of a task group
+	/// @details Tasks subsequently run with this tag are placed in the earliest-deadline-first lane. Each time one of
+	/// them wakes, it must be resumed within @p in_latency (tasks already running keep the lane they were run in).
+	void SetTaskGroupDeadline(tTaskTag in_tag, std::optional<tTaskClock::duration> in_latency)
+	{
+		TaskGroup& group = GetOrAddGroup(in_tag);
+		group.resumeLatency = in_latency;
+		MarkGroupDirty(&group); // Allow the group to be pruned if the deadline was cleared
+	}
+
+	/// Returns the resume deadline of a task group (if any)
+	std::optional<tTaskClock::duration> GetTaskGroupDeadline(tTaskTag in_tag) const
+	{
+		const TaskGroup* group = FindGroup(in_tag);
+		return group ? group->resumeLatency : std::nullopt;
+	}
+
+	/// @brief Set the weight of a task group's share of the budget in budgeted updates (default 1.0)
+	/// @details Setting the weight of a task group keeps the group (and its resume time accounting) alive while it is empty.
+	void SetTaskGroupWeight(tTaskTag in_tag, float in_weight)
+	{
+		SQUID_RUNTIME_CHECK(in_weight > 0.0f, "Task group weight must be greater than zero");
+		TaskGroup& group = GetOrAddGroup(in_tag);
+		group.share.weight = in_weight;
+		group.hasWeight = true;
+	}
+
+	/// Returns the weight of a task group's share of the budget in budgeted updates
+	float GetTaskGroupWeight(tTaskTag in_tag) const
+	{
+		const TaskGroup* group = FindGroup(in_tag);
+		return group ? group->share.weight : 1.0f;
+	}
+
+	/// @brief Set (or clear) the update interval of a task group
+	/// @details Tasks in the group are only resumed by Update() when they are due to tick (or when a timer they are
+	/// waiting on has expired). Tasks in the EDF lane are always resumed when they wake.
+	void SetTaskGroupUpdateInterval(tTaskTag in_tag, std::optional<TaskUpdateInterval> in_interval)
+	{
+		TaskGroup& group = GetOrAddGroup(in_tag);
+		group.updateInterval = std::move(in_interval);
+		MarkGroupDirty(&group); // Allow the group to be pruned if the interval was cleared
+	}
+
+	/// Returns the total measured time spent resuming the tasks of a task group during budgeted updates
+	tTaskClock::duration GetTaskGroupResumeTime(tTaskTag in_tag) const
+	{
+		const TaskGroup* group = FindGroup(in_tag);
+		return group ? group->share.resumeTime : tTaskClock::duration::zero();
+	}
+	///@} end of Task Groups
+
+	/// @brief Set a function that is called whenever a task in the EDF lane misses its resume deadline
+	/// @details The function is passed the late task and how far past its deadline it was when the miss was detected.
+	/// Each wake of a task is reported at most once.
+	void SetDeadlineMissFn(std::function<void(const WeakTaskHandle&, tTaskClock::duration)> in_deadlineMissFn)
+	{
+		m_deadlineMissFn = std::move(in_deadlineMissFn);
+	}
+
+	/// Returns the total number of resume deadlines missed by tasks in the EDF lane
+	uint64_t GetDeadlineMissCount() const
+	{
+		return m_numDeadlineMisses;
+	}
+
+	/// @brief Set (or clear) the update interval of a single task (overriding the interval of its task group)
+	/// @details This is O(n) in the number of tasks on the manager.
+	void SetTaskUpdateInterval(const WeakTaskHandle& in_task, std::optional<TaskUpdateInterval> in_interval)
+	{
+		auto SetInterval = [&in_task, &in_interval](std::vector<TaskEntry>& in_tasks) {
+			for(auto& entry : in_tasks)
+			{
+				if(entry.task.m_taskInternal == in_task.m_taskInternal)
+				{
+					entry.updateInterval = in_interval ? std::make_unique<TaskUpdateInterval>(in_interval.value()) : nullptr;
+					entry.nextTickTime.reset();
+					return true;
+				}
+			}
+			return false;
+		};
+		if(in_task.IsValid() && !SetInterval(m_tasks) && !SetInterval(m_deadlineTasks))
+		{
+			for(auto& groupPair : m_groups)
+			{
+				if(SetInterval(groupPair.second.pausedTasks))
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	/// Set the weight of the untagged tasks' share of the budget in budgeted updates (default 1.0)
+	void SetUntaggedTaskWeight(float in_weight)
+	{
+		SQUID_RUNTIME_CHECK(in_weight > 0.0f, "Untagged task weight must be greater than zero");
+		m_untaggedShare.weight = in_weight;
+	}
+
+	/// Returns the total measured time spent resuming untagged tasks during budgeted updates
+	tTaskClock::duration GetUntaggedTaskResumeTime() const
+	{
+		return m_untaggedShare.resumeTime;
+	}
+
+	/// @brief Enable fast-forward mode, in which each update first advances a virtual time-stream to the next timer deadline
+	/// whenever no task is ready to resume (pass nullptr to disable)
+	/// @details Intended for offline simulations (e.g. balancing or soak tests), in which every timer that tasks await
+	/// should be measured in the virtual time-stream. If tasks are waiting on predicates (which may become true at any time),
+	/// time is instead advanced by @p in_predicateStep. Time is never advanced while a task is ready to resume, so tasks
+	/// that resume every update (e.g. by awaiting Suspend()) must be paired with explicit calls to
+	/// @ref VirtualTimeStream::Advance(). Update intervals (see @ref TaskUpdateInterval) are not taken into account.
+	void SetFastForwardTimeStream(VirtualTimeStream* in_timeStream, tTaskTime in_predicateStep = 0)
+	{
+		m_fastForwardTimeStream = in_timeStream;
+		m_fastForwardPredicateStep = in_predicateStep;
+	}
+
+	/// @brief Advance a virtual time-stream to the next timer deadline if no task is ready to resume (returns the time skipped)
+	/// @details This is what each update does in fast-forward mode (see @ref SetFastForwardTimeStream()). Time is advanced
+	/// by @p in_predicateStep if tasks are waiting on predicates, and not at all if a task is ready to resume (or if no
+	/// task will ever wake).
+	tTaskTime FastForward(VirtualTimeStream& io_timeStream, tTaskTime in_predicateStep = 0) const
+	{
+		TaskWakeTime wakeTime = GetNextWakeTime();
+		tTaskTime startTime = io_timeStream.GetTime();
+		for(int32_t numJumps = 0; wakeTime.type == TaskWakeTime::eType::Timer && numJumps < 4; ++numJumps)
+		{
+			// Jump to the deadline (making sure time moves forward, as the deadline may be within rounding error of now)
+			tTaskTime time = io_timeStream.GetTime();
+			tTaskTime deadline = time + wakeTime.timeRemaining.value();
+#if SQUID_TIME_TICKS
+			io_timeStream.SetTime(deadline > time ? deadline : time + 1);
+#else
+			io_timeStream.SetTime(deadline > time ? deadline : std::nextafter(time, std::numeric_limits<tTaskTime>::max()));
+#endif //SQUID_TIME_TICKS
+			// Rounding may leave the timer just short of expiring (stop if the jump made no progress, e.g. because the timer
+			// is measured in a different time-stream)
+			tTaskTime prevTimeRemaining = wakeTime.timeRemaining.value();
+			wakeTime = GetNextWakeTime();
+			if(wakeTime.type == TaskWakeTime::eType::Timer && !(wakeTime.timeRemaining.value() < prevTimeRemaining))
+			{
+				break;
+			}
+		}
+		if(wakeTime.type == TaskWakeTime::eType::Unknown && io_timeStream.GetTime() == startTime)
+		{
+			io_timeStream.Advance(in_predicateStep);
+		}
+		return io_timeStream.GetTime() - startTime;
+	}
+
+	/// @brief Register a time-stream to be snapshotted at the start of each update (see @ref TimeStream)
+	/// @details The time-stream must remain alive until it is removed (or the task manager is destroyed).
+	void AddTimeStream(TimeStream& in_timeStream)
+	{
+		if(std::find(m_timeStreams.begin(), m_timeStreams.end(), &in_timeStream) == m_timeStreams.end())
+		{
+			m_timeStreams.push_back(&in_timeStream);
+		}
+	}
+
+	/// Unregister a time-stream that was registered with AddTimeStream()
+	void RemoveTimeStream(TimeStream& in_timeStream)
+	{
+		m_timeStreams.erase(std::remove(m_timeStreams.begin(), m_timeStreams.end(), &in_timeStream), m_timeStreams.end());
+	}
+
+	/// @brief Create a polled time-stream that is owned by the task manager, and snapshotted at the start of each update
+	/// @details Timers in a polled time-stream (e.g. from WaitSeconds(seconds, timeStream)) are re-evaluated in a single
+	/// batch against the stream's time on every update (see @ref PolledTimeStream). This suits time functions that can move
+	/// backwards, which cannot use a regular @ref TimeStream. The stream lives until the task manager is destroyed, and
+	/// must not be used by tasks that outlive the task manager.
+	template <typename tTimeFn>
+	PolledTimeStream& AddPolledTimeStream(tTimeFn in_timeFn)
+	{
+		m_polledTimeStreams.push_back(std::make_unique<PolledTimeStream>(in_timeFn));
+		PolledTimeStream& timeStream = *m_polledTimeStreams.back();
+		AddTimeStream(timeStream);
+		return timeStream;
 	}
 
 	/// Call @ref Task::Resume() on all active tasks exactly once (managed + unmanaged)
 	void Update()
 	{
+		TaskInternalBase::UpdateScope updateScope;
+		++m_numUpdates;
+		SnapshotTimeStreams();
+
+		// Skip ahead to the next timer deadline if nothing is ready to resume (fast-forward mode only)
+		if(m_fastForwardTimeStream)
+		{
+			FastForward(*m_fastForwardTimeStream, m_fastForwardPredicateStep);
+		}
+
+		// Return any unpaused tasks to the update list
+		RestoreUnpausedTasks();
+
+		// Resume woken tasks in the EDF lane (nearest deadline first)
+		ResumeDeadlineTasks({});
+
 		// Resume all tasks
 		size_t writeIdx = 0;
 		for(size_t readIdx = 0; readIdx < m_tasks.size(); ++readIdx)
 		{
-			if(m_tasks[readIdx].Resume() != eTaskStatus::Done)
+			TaskGroup* group = m_tasks[readIdx].group;
+			if(group && group->isPaused)
+			{
+				group->pausedTasks.push_back(std::move(m_tasks[readIdx])); // Move paused tasks out of the update list
+			}
+			else if(IsTickDue(m_tasks[readIdx]) ? m_tasks[readIdx].task.Resume() != eTaskStatus::Done : !m_tasks[readIdx].task.IsDone())
 			{
 				if(writeIdx != readIdx)
 				{
@@ -182,36 +755,831 @@ public:
 				}
 				++writeIdx;
 			}
+			else if(group)
+			{
+				--group->numEntries;
+				MarkGroupDirty(group);
+			}
 		}
 		m_tasks.resize(writeIdx);
 
-		// Prune strong tasks that are done
-		auto removeIt = m_strongRefs.erase(std::remove_if(m_strongRefs.begin(), m_strongRefs.end(), [](const auto& in_taskHandle) {
-			return in_taskHandle.IsDone();
-		}), m_strongRefs.end());
+		// Prune done tasks
+		PruneDoneTasks();
+	}
+
+	/// @brief Call @ref Task::Resume() on active tasks until the given time budget has been spent
+	/// @details Woken tasks in the EDF lane are resumed first (nearest deadline first). The budget is then shared between
+	/// task groups according to their weights. Any tasks that are skipped once the budget has been spent are the first to
+	/// be resumed during the next update.
+	void Update(tTaskClock::duration in_budget)
+	{
+		TaskInternalBase::UpdateScope updateScope;
+		tTaskClock::time_point budgetEnd = tTaskClock::now() + in_budget;
+		++m_numUpdates;
+		SnapshotTimeStreams();
+
+		// Skip ahead to the next timer deadline if nothing is ready to resume (fast-forward mode only)
+		if(m_fastForwardTimeStream)
+		{
+			FastForward(*m_fastForwardTimeStream, m_fastForwardPredicateStep);
+		}
+
+		// Return any unpaused tasks to the update list
+		RestoreUnpausedTasks();
+
+		// Allot each task group its share of the budget
+		AllotBudgetShares(in_budget);
+
+		// Resume woken tasks in the EDF lane (nearest deadline first)
+		ResumeDeadlineTasks(budgetEnd);
+
+		// Resume tasks in update order, starting with the first task that was skipped by the previous update
+		auto startIter = std::lower_bound(m_tasks.begin(), m_tasks.end(), m_resumeCursor, [](const TaskEntry& in_entry, uint64_t in_order) {
+			return in_entry.order < in_order;
+		});
+		size_t startIdx = (size_t)std::distance(m_tasks.begin(), startIter);
+		m_resumeCursor = 0;
+		m_overQuotaTasks.clear();
+		auto ResumeWithinBudget = [this, budgetEnd](size_t in_idx) {
+			TaskGroup* group = m_tasks[in_idx].group;
+			if(group && group->isPaused)
+			{
+				return true; // Paused tasks are moved out of the update list below
+			}
+			tTaskClock::time_point resumeStart = tTaskClock::now();
+			if(resumeStart >= budgetEnd)
+			{
+				m_resumeCursor = m_tasks[in_idx].order; // Out of budget (resume from this task next update)
+				return false;
+			}
+			TaskShare& share = GetShare(group);
+			if(share.balance <= tTaskClock::duration::zero())
+			{
+				m_overQuotaTasks.push_back(in_idx); // Group has spent its share (resume later if there is budget left over)
+				return true;
+			}
+			if(!IsTickDue(m_tasks[in_idx]))
+			{
+				return true;
+			}
+			m_tasks[in_idx].task.Resume();
+			ChargeResumeTime(share, tTaskClock::now() - resumeStart, true);
+			return true;
+		};
+		bool isWithinBudget = true;
+		for(size_t idx = startIdx; isWithinBudget && idx < m_tasks.size(); ++idx) // Includes tasks run during this loop
+		{
+			isWithinBudget = ResumeWithinBudget(idx);
+		}
+		for(size_t idx = 0; isWithinBudget && idx < startIdx; ++idx)
+		{
+			isWithinBudget = ResumeWithinBudget(idx);
+		}
+
+		// Spend any leftover budget on tasks whose groups have spent their share (without charging it as debt)
+		for(size_t idx : m_overQuotaTasks)
+		{
+			tTaskClock::time_point resumeStart = tTaskClock::now();
+			if(resumeStart >= budgetEnd)
+			{
+				if(isWithinBudget)
+				{
+					m_resumeCursor = m_tasks[idx].order; // Out of budget (resume from this task next update, so it is not starved)
+				}
+				break;
+			}
+			TaskGroup* group = m_tasks[idx].group;
+			if((!group || !group->isPaused) && IsTickDue(m_tasks[idx]))
+			{
+				m_tasks[idx].task.Resume();
+				ChargeResumeTime(GetShare(group), tTaskClock::now() - resumeStart, false);
+			}
+		}
+		RemoveInactiveTasks(m_tasks);
+
+		// Prune done tasks
+		PruneDoneTasks();
+	}
+
+	/// @brief Returns an estimate of when the next update will have a task to resume
+	/// @details The estimate is "now" if any task is ready to resume, "unknown" if any task is waiting on a predicate
+	/// (which may become true at any time), otherwise the earliest deadline of the timers that tasks are awaiting (see
+	/// @ref TaskTimer). Tasks awaiting WaitSeconds() or a TaskTimer have known deadlines, whereas tasks awaiting
+	/// WaitForever() will never wake. Paused tasks are ignored.
+	TaskWakeTime GetNextWakeTime() const
+	{
+		TaskWakeTime nextWakeTime;
+		for(const auto* tasks : { &m_deadlineTasks, &m_tasks })
+		{
+			for(const auto& entry : *tasks)
+			{
+				if(!entry.task.IsDone() && !(entry.group && entry.group->isPaused))
+				{
+					nextWakeTime = TaskWakeTime::Earliest(nextWakeTime, entry.task.m_taskInternal->GetWakeTime());
+					if(nextWakeTime.type == TaskWakeTime::eType::Now)
+					{
+						return nextWakeTime;
+					}
+				}
+			}
+		}
+		if(!m_unpausedGroups.empty())
+		{
+			nextWakeTime.type = TaskWakeTime::eType::Now; // Unpaused tasks rejoin the update list during the next update
+		}
+		return nextWakeTime;
 	}
 
 	/// Get a debug string containing a list of all active tasks
 	std::string GetDebugString(std::optional<TaskDebugStackFormatter> in_formatter = {}) const
 	{
 		std::string debugStr;
-		for(const auto& task : m_tasks)
+		for(const auto* tasks : { &m_deadlineTasks, &m_tasks })
 		{
-			if(!task.IsDone())
+			for(const auto& entry : *tasks)
 			{
-				if(debugStr.size())
+				const auto& task = entry.task;
+				if(!task.IsDone())
 				{
-					debugStr += '\n';
+					if(debugStr.size())
+					{
+						debugStr += '\n';
+					}
+					debugStr += task.GetDebugStack(in_formatter);
+				}
+			}
+		}
+		for(const auto& groupPair : m_groups)
+		{
+			for(const auto& entry : groupPair.second.pausedTasks)
+			{
+				if(!entry.task.IsDone())
+				{
+					if(debugStr.size())
+					{
+						debugStr += '\n';
+					}
+					debugStr += entry.task.GetDebugStack(in_formatter) + " [PAUSED]";
 				}
-				debugStr += task.GetDebugStack(in_formatter);
 			}
 		}
 		return debugStr;
 	}
 
 private:
-	std::vector<WeakTask> m_tasks;
+	struct TaskGroup;
+
+	// Task entry (a task + the group it belongs to)
+	struct TaskEntry
+	{
+		TaskEntry() = default;
+		TaskEntry(WeakTask&& in_task, TaskGroup* in_group, uint64_t in_order, bool in_isDeadlineTask = false)
+			: task(std::move(in_task))
+			, group(in_group)
+			, order(in_order)
+			, isDeadlineTask(in_isDeadlineTask)
+		{
+		}
+
+		WeakTask task;
+		TaskGroup* group = nullptr; // Task groups are stored in an unordered_map, so their addresses are stable
+		uint64_t order = 0; // Order in which the task was run (used to restore update order when unpausing)
+		bool isDeadlineTask = false; // Whether the task is in the EDF lane
+		bool isDeadlineMissed = false; // Whether a deadline miss has been reported for the current wake
+		std::optional<tTaskClock::time_point> deadline; // Resume deadline (set when an EDF lane task wakes)
+		std::unique_ptr<TaskUpdateInterval> updateInterval; // Per-task update interval (overrides the group's interval)
+		std::optional<tTaskTime> nextTickTime; // Next tick time (for update intervals measured in seconds)
+	};
+
+	// Share of the budget of a budgeted update (used for weighted fair queuing between task groups)
+	struct TaskShare
+	{
+		float weight = 1.0f;
+		tTaskClock::duration balance = tTaskClock::duration::zero(); // Remaining share of the current update's budget (negative when in debt)
+		tTaskClock::duration resumeTime = tTaskClock::duration::zero(); // Total measured time spent resuming tasks
+		uint64_t allotUpdateIdx = 0; // Index of the last budgeted update in which this share was allotted
+	};
+
+	// Task group (all tasks run with a given tag)
+	struct TaskGroup
+	{
+		tTaskTag tag = 0;
+		std::vector<WeakTaskHandle> tasks; // Handles to the tasks in this group (in the order they were run)
+		std::vector<TaskEntry> pausedTasks; // Tasks removed from the update list while paused (in update order)
+		size_t numEntries = 0; // Number of task entries (in any list) that point to this group
+		bool isDirty = false; // Whether a task in this group has terminated since the group was last pruned
+		bool isPaused = false;
+		std::optional<tTaskClock::duration> resumeLatency; // Resume deadline of tasks in this group, relative to when they wake
+		TaskShare share;
+		bool hasWeight = false; // Whether a weight has been explicitly set for this group
+		std::optional<TaskUpdateInterval> updateInterval;
+	};
+
+	// Running tasks
+	void AddTask(WeakTask&& in_task, TaskGroup* in_group)
+	{
+		// Add the task to its task group (if tagged)
+		if(in_group)
+		{
+			in_group->tasks.push_back(in_task);
+			++in_group->numEntries;
+			if(in_group->isPaused)
+			{
+				// Tasks run on a paused group start out paused
+				in_task.m_taskInternal->PauseTimers();
+				in_group->pausedTasks.push_back({ std::move(in_task), in_group, m_nextOrder++, in_group->resumeLatency.has_value() });
+				return;
+			}
+		}
+
+		// Run unmanaged task (in the EDF lane, if its group has a resume deadline)
+		if(in_group && in_group->resumeLatency)
+		{
+			m_deadlineTasks.push_back({ std::move(in_task), in_group, m_nextOrder++, true });
+			return;
+		}
+		m_tasks.push_back({ std::move(in_task), in_group, m_nextOrder++ });
+	}
+	TaskGroup* PrepareToRunMany(size_t in_numTasks, std::optional<tTaskTag> in_tag)
+	{
+		// Grow the lists the tasks will be added to (at most once)
+		TaskGroup* group = in_tag ? &GetOrAddGroup(in_tag.value()) : nullptr;
+		if(group)
+		{
+			group->tasks.reserve(group->tasks.size() + in_numTasks);
+		}
+		auto& tasks = !group ? m_tasks : group->isPaused ? group->pausedTasks : group->resumeLatency ? m_deadlineTasks : m_tasks;
+		tasks.reserve(tasks.size() + in_numTasks);
+		return group;
+	}
+
+	// Task groups
+	TaskGroup& GetOrAddGroup(tTaskTag in_tag)
+	{
+		TaskGroup& group = m_groups[in_tag];
+		group.tag = in_tag;
+		return group;
+	}
+	TaskGroup* FindGroup(tTaskTag in_tag)
+	{
+		auto foundIter = m_groups.find(in_tag);
+		return foundIter != m_groups.end() ? &foundIter->second : nullptr;
+	}
+	const TaskGroup* FindGroup(tTaskTag in_tag) const
+	{
+		auto foundIter = m_groups.find(in_tag);
+		return foundIter != m_groups.end() ? &foundIter->second : nullptr;
+	}
+	void MarkGroupDirty(TaskGroup* in_group)
+	{
+		if(!in_group->isDirty)
+		{
+			in_group->isDirty = true;
+			m_dirtyGroups.push_back(in_group);
+		}
+	}
+	static bool HasGroupSettings(const TaskGroup& in_group) // Whether a group must be kept even while it has no tasks
+	{
+		return in_group.isPaused || in_group.resumeLatency || in_group.hasWeight || in_group.updateInterval;
+	}
+	void PruneDirtyGroups()
+	{
+		// Groups are only erased once no task entry points to them (a task that is killed after its entry has been visited
+		// by the current update keeps its entry until the next update)
+		for(TaskGroup* group : m_dirtyGroups)
+		{
+			group->isDirty = false;
+			group->tasks.erase(std::remove_if(group->tasks.begin(), group->tasks.end(), [](const WeakTaskHandle& in_task) {
+				return in_task.IsDone();
+			}), group->tasks.end());
+			if(group->tasks.empty() && group->numEntries == 0 && !HasGroupSettings(*group))
+			{
+				m_groups.erase(group->tag); // Invalidates group
+			}
+		}
+		m_dirtyGroups.clear();
+	}
+	void RestoreUnpausedTasks()
+	{
+		// Merge paused tasks back into their update lists (preserving the order in which tasks were run)
+		auto IsOrderedBefore = [](const TaskEntry& in_lhs, const TaskEntry& in_rhs) {
+			return in_lhs.order < in_rhs.order;
+		};
+		auto MergeTasks = [&IsOrderedBefore](std::vector<TaskEntry>& in_tasks, auto in_begin, auto in_end) {
+			size_t numTasks = in_tasks.size();
+			std::move(in_begin, in_end, std::back_inserter(in_tasks));
+			std::inplace_merge(in_tasks.begin(), in_tasks.begin() + numTasks, in_tasks.end(), IsOrderedBefore);
+		};
+		for(tTaskTag tag : m_unpausedGroups)
+		{
+			TaskGroup* group = FindGroup(tag);
+			if(group && !group->isPaused && !group->pausedTasks.empty())
+			{
+				auto& pausedTasks = group->pausedTasks;
+				std::sort(pausedTasks.begin(), pausedTasks.end(), IsOrderedBefore); // Tasks may have been paused from either lane
+				auto deadlineIter = std::stable_partition(pausedTasks.begin(), pausedTasks.end(), [](const TaskEntry& in_entry) {
+					return !in_entry.isDeadlineTask;
+				});
+				MergeTasks(m_tasks, pausedTasks.begin(), deadlineIter);
+				MergeTasks(m_deadlineTasks, deadlineIter, pausedTasks.end());
+				pausedTasks.clear();
+			}
+		}
+		m_unpausedGroups.clear();
+	}
+
+	// Update helpers
+	void SnapshotTimeStreams()
+	{
+		for(TimeStream* timeStream : m_timeStreams)
+		{
+			timeStream->Snapshot();
+		}
+	}
+	bool IsTickDue(TaskEntry& in_entry)
+	{
+		// Tasks without an update interval tick every update
+		const TaskUpdateInterval* interval = in_entry.updateInterval.get();
+		if(!interval && in_entry.group && in_entry.group->updateInterval)
+		{
+			interval = &in_entry.group->updateInterval.value();
+		}
+		if(!interval || interval->Tick(m_numUpdates, in_entry.order, in_entry.nextTickTime))
+		{
+			return true;
+		}
+
+		// Between ticks, only resume tasks that have been stopped or that have an expired timer (to honor exact deadlines)
+		const auto& taskInternal = in_entry.task.m_taskInternal;
+		return taskInternal && (taskInternal->IsStopRequested() || taskInternal->HasExpiredTimers());
+	}
+	TaskShare& GetShare(TaskGroup* in_group)
+	{
+		return in_group ? in_group->share : m_untaggedShare;
+	}
+	void AllotBudgetShares(tTaskClock::duration in_budget)
+	{
+		// Gather the shares of all groups with tasks to resume
+		++m_numBudgetedUpdates;
+		m_activeShares.clear();
+		float totalWeight = 0.0f;
+		auto AddShare = [this, &totalWeight](TaskGroup* in_group) {
+			TaskShare& share = GetShare(in_group);
+			if(share.allotUpdateIdx != m_numBudgetedUpdates && !(in_group && in_group->isPaused))
+			{
+				share.allotUpdateIdx = m_numBudgetedUpdates;
+				m_activeShares.push_back(&share);
+				totalWeight += share.weight;
+			}
+		};
+		for(const auto& entry : m_deadlineTasks)
+		{
+			AddShare(entry.group);
+		}
+		for(const auto& entry : m_tasks)
+		{
+			AddShare(entry.group);
+		}
+
+		// Allot each share its weighted portion of the budget (unspent budget is not carried over, but debt is)
+		for(TaskShare* share : m_activeShares)
+		{
+			auto quota = std::chrono::duration_cast<tTaskClock::duration>(in_budget * (share->weight / totalWeight));
+			share->balance = std::min(share->balance + quota, quota);
+		}
+	}
+	static void ChargeResumeTime(TaskShare& in_share, tTaskClock::duration in_resumeTime, bool in_isChargedToBalance)
+	{
+		in_share.resumeTime += in_resumeTime;
+		if(in_isChargedToBalance)
+		{
+			in_share.balance -= in_resumeTime;
+		}
+	}
+	void ResumeDeadlineTasks(std::optional<tTaskClock::time_point> in_budgetEnd)
+	{
+		if(m_deadlineTasks.empty())
+		{
+			return;
+		}
+
+		// Stamp deadlines on newly-woken tasks and gather all woken tasks
+		tTaskClock::time_point now = tTaskClock::now();
+		m_wokenDeadlineTasks.clear();
+		for(size_t idx = 0; idx < m_deadlineTasks.size(); ++idx)
+		{
+			TaskEntry& entry = m_deadlineTasks[idx];
+			if(entry.task.IsDone() || entry.group->isPaused)
+			{
+				continue;
+			}
+			if(entry.task.m_taskInternal->CanResume() || entry.task.IsStopRequested())
+			{
+				if(!entry.deadline)
+				{
+					entry.deadline = now + entry.group->resumeLatency.value_or(tTaskClock::duration::zero());
+					entry.isDeadlineMissed = false;
+				}
+				m_wokenDeadlineTasks.push_back(idx);
+			}
+			else
+			{
+				entry.deadline.reset();
+			}
+		}
+		std::sort(m_wokenDeadlineTasks.begin(), m_wokenDeadlineTasks.end(), [this](size_t in_lhs, size_t in_rhs) {
+			const TaskEntry& lhs = m_deadlineTasks[in_lhs];
+			const TaskEntry& rhs = m_deadlineTasks[in_rhs];
+			return lhs.deadline != rhs.deadline ? lhs.deadline < rhs.deadline : lhs.order < rhs.order;
+		});
+
+		// Resume woken tasks (nearest deadline first) until the budget is spent
+		size_t numResumed = 0;
+		for(; numResumed < m_wokenDeadlineTasks.size(); ++numResumed)
+		{
+			if(in_budgetEnd && now >= in_budgetEnd.value())
+			{
+				break;
+			}
+			size_t idx = m_wokenDeadlineTasks[numResumed];
+			tTaskClock::time_point deadline = m_deadlineTasks[idx].deadline.value();
+			bool isMissed = now > deadline && !m_deadlineTasks[idx].isDeadlineMissed;
+			m_deadlineTasks[idx].deadline.reset();
+			if(isMissed)
+			{
+				ReportDeadlineMiss(m_deadlineTasks[idx].task, now - deadline);
+			}
+			TaskGroup* group = m_deadlineTasks[idx].group;
+			m_deadlineTasks[idx].task.Resume();
+			tTaskClock::time_point resumeEnd = tTaskClock::now();
+			if(in_budgetEnd)
+			{
+				ChargeResumeTime(group->share, resumeEnd - now, true); // EDF tasks are not limited by their share, but still consume it
+			}
+			now = resumeEnd;
+		}
+
+		// Report misses for any woken tasks that are already past their deadline but did not fit in the budget
+		for(; numResumed < m_wokenDeadlineTasks.size(); ++numResumed)
+		{
+			TaskEntry& entry = m_deadlineTasks[m_wokenDeadlineTasks[numResumed]];
+			if(now > entry.deadline.value() && !entry.isDeadlineMissed)
+			{
+				entry.isDeadlineMissed = true;
+				ReportDeadlineMiss(entry.task, now - entry.deadline.value());
+			}
+		}
+		RemoveInactiveTasks(m_deadlineTasks);
+	}
+	void ReportDeadlineMiss(const WeakTask& in_task, tTaskClock::duration in_lateness)
+	{
+		++m_numDeadlineMisses;
+		if(m_deadlineMissFn)
+		{
+			WeakTaskHandle taskHandle = in_task; // Copy the handle (the miss function may run tasks on this manager)
+			m_deadlineMissFn(taskHandle, in_lateness);
+		}
+	}
+	void RemoveInactiveTasks(std::vector<TaskEntry>& in_tasks)
+	{
+		// Remove done tasks and move paused tasks out of an update list (preserving update order)
+		size_t writeIdx = 0;
+		for(size_t readIdx = 0; readIdx < in_tasks.size(); ++readIdx)
+		{
+			TaskEntry& entry = in_tasks[readIdx];
+			if(entry.task.IsDone())
+			{
+				if(entry.group)
+				{
+					--entry.group->numEntries;
+					MarkGroupDirty(entry.group);
+				}
+			}
+			else if(entry.group && entry.group->isPaused)
+			{
+				entry.deadline.reset(); // Paused tasks are re-stamped when they wake after being unpaused
+				entry.group->pausedTasks.push_back(std::move(entry));
+			}
+			else
+			{
+				if(writeIdx != readIdx)
+				{
+					in_tasks[writeIdx] = std::move(entry);
+				}
+				++writeIdx;
+			}
+		}
+		in_tasks.resize(writeIdx);
+	}
+	void PruneDoneTasks()
+	{
+		// Prune strong tasks that are done
+		m_strongRefs.erase(std::remove_if(m_strongRefs.begin(), m_strongRefs.end(), [](const auto& in_taskHandle) {
+			return in_taskHandle.IsDone();
+		}), m_strongRefs.end());
+
+		// Prune task groups that had tasks terminate
+		PruneDirtyGroups();
+	}
+
+	// Fence task that waits until all the given tasks have terminated
+	static Task<> MakeFenceTask(std::vector<WeakTaskHandle> in_weakHandles, const char* in_debugName)
+	{
+		return [](std::vector<WeakTaskHandle> in_weakHandles, const char* in_debugName) -> Task<> {
+			TASK_NAME(in_debugName);
+			(void)in_debugName; // (Unused when task debugging is disabled)
+			for(const auto& weakHandle : in_weakHandles)
+			{
+				co_await weakHandle; // Wait until task is complete
+			}
+		}(std::move(in_weakHandles), in_debugName);
+	}
+
+	std::vector<std::unique_ptr<PolledTimeStream>> m_polledTimeStreams; // (Declared first, so they outlive the tasks waiting in them)
+	std::vector<TaskEntry> m_tasks;
+	std::vector<TaskEntry> m_deadlineTasks; // EDF lane
+	std::vector<size_t> m_wokenDeadlineTasks; // Scratch list of woken EDF lane tasks (indices into m_deadlineTasks)
+	std::vector<size_t> m_overQuotaTasks; // Scratch list of tasks skipped because their group spent its share (indices into m_tasks)
+	std::vector<TaskShare*> m_activeShares; // Scratch list of shares allotted during the current budgeted update
 	std::vector<TaskHandle<>> m_strongRefs;
+	std::unordered_map<tTaskTag, TaskGroup> m_groups;
+	std::vector<TaskGroup*> m_dirtyGroups;
+	std::vector<tTaskTag> m_unpausedGroups;
+	uint64_t m_nextOrder = 0;
+	uint64_t m_resumeCursor = 0; // Order of the first task to resume during the next budgeted update
+	std::function<void(const WeakTaskHandle&, tTaskClock::duration)> m_deadlineMissFn;
+	uint64_t m_numDeadlineMisses = 0;
+	TaskShare m_untaggedShare; // Budget share of all untagged tasks
+	uint64_t m_numBudgetedUpdates = 0;
+	uint64_t m_numUpdates = 0;
+	std::vector<TimeStream*> m_timeStreams; // Time-streams snapshotted at the start of each update
+	VirtualTimeStream* m_fastForwardTimeStream = nullptr; // Time-stream advanced by each update in fast-forward mode
+	tTaskTime m_fastForwardPredicateStep = 0;
+};
+
+//--- TaskRunLoop ---//
+/// @brief Loop that updates a TaskManager, sleeping the thread whenever no task is ready to resume
+/// @details Intended for headless processes (e.g. servers). Between updates, the loop sleeps until the manager's next
+/// timer deadline (see @ref TaskManager::GetNextWakeTime()), or until another thread calls Wake() (e.g. after queueing
+/// work that a task is waiting on). Timer deadlines are assumed to be measured in real time.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// TaskRunLoop runLoop(taskMgr);
+/// runLoop.Run([] {
+/// 	TimeSystem::UpdateTime(); // Called before each update
+/// 	return !g_isShuttingDown; // Keep running until shutdown
+/// });
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class TaskRunLoop
+{
+public:
+	/// Construct a run loop for a task manager (the task manager must outlive the run loop)
+	TaskRunLoop(TaskManager& in_taskMgr)
+		: m_taskMgr(in_taskMgr)
+	{
+	}
+
+	/// @brief Run the loop until the pre-update function returns false (or Stop() is called)
+	/// @details The pre-update function is called before each update (e.g. to update time-streams). While any task is
+	/// waiting on a predicate, the loop polls at @p in_pollInterval. If no task will ever wake on its own, the loop sleeps
+	/// until Wake() or Stop() is called.
+	void Run(std::function<bool()> in_preUpdateFn, tTaskClock::duration in_pollInterval = std::chrono::milliseconds(10))
+	{
+		while(!m_isStopRequested && (!in_preUpdateFn || in_preUpdateFn()))
+		{
+			m_taskMgr.Update();
+
+			// Sleep until the next task is ready to resume (or until woken)
+			std::optional<tTaskClock::duration> sleepTime = GetSleepTime(m_taskMgr.GetNextWakeTime(), in_pollInterval);
+			if(!sleepTime || sleepTime.value() > tTaskClock::duration::zero())
+			{
+				Sleep(sleepTime);
+			}
+		}
+	}
+
+	/// @brief Returns how long a loop can sleep before a task is ready to resume (or no value, if it can sleep until woken)
+	/// @details Timer deadlines are assumed to be measured in seconds of real time.
+	static std::optional<tTaskClock::duration> GetSleepTime(const TaskWakeTime& in_wakeTime, tTaskClock::duration in_pollInterval)
+	{
+		if(in_wakeTime.type == TaskWakeTime::eType::Now)
+		{
+			return tTaskClock::duration::zero();
+		}
+		std::optional<tTaskClock::duration> sleepTime;
+		if(in_wakeTime.timeRemaining)
+		{
+			sleepTime = std::chrono::duration_cast<tTaskClock::duration>(std::chrono::duration<double>(TaskTimeToSeconds(in_wakeTime.timeRemaining.value())));
+		}
+		if(in_wakeTime.type == TaskWakeTime::eType::Unknown)
+		{
+			sleepTime = sleepTime ? std::min(sleepTime.value(), in_pollInterval) : in_pollInterval;
+		}
+		return sleepTime;
+	}
+
+	/// Wake the loop if it is sleeping (thread-safe)
+	void Wake()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isWakeRequested = true;
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	/// Stop the loop after its current update (thread-safe, and may be called before Run(), in which case Run() returns immediately)
+	void Stop()
+	{
+		m_isStopRequested = true;
+		Wake();
+	}
+
+private:
+	void Sleep(std::optional<tTaskClock::duration> in_sleepTime)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		auto IsWakeRequested = [this] { return m_isWakeRequested; };
+		if(in_sleepTime)
+		{
+			m_wakeCondition.wait_for(lock, in_sleepTime.value(), IsWakeRequested);
+		}
+		else
+		{
+			m_wakeCondition.wait(lock, IsWakeRequested); // Nothing will wake on its own, so wait for an external wake
+		}
+		m_isWakeRequested = false;
+	}
+
+	TaskManager& m_taskMgr;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	bool m_isWakeRequested = false;
+	std::atomic<bool> m_isStopRequested = false;
+};
+
+//--- FixedStepRunner ---//
+/// @brief Runs a TaskManager at a fixed timestep (e.g. 60Hz), decoupled from the rate at which frames are ticked
+/// @details Each call to Tick() adds the wall-clock time since the previous tick to an accumulator, and then runs one
+/// update of the task manager for each whole step in the accumulator. Before each update, the runner's fixed-step
+/// time-stream (see GetTimeFn()) advances by exactly one step, so tasks waiting in it behave deterministically no matter
+/// how frames are paced. If a frame takes so long that more than the maximum number of steps per tick are due, the
+/// surplus is dropped (see GetDroppedTime()), so a long stall cannot cause a spiral of ever-longer catch-up frames.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// FixedStepRunner simRunner(m_simTaskMgr, std::chrono::microseconds(16667)); // ~60Hz
+/// m_simTaskMgr.RunManaged(SpawnWaves(simRunner.GetTimeFn()));
+/// while(!g_isShuttingDown)
+/// {
+/// 	simRunner.Tick(); // Runs 0 or more simulation steps
+/// 	Render(simRunner.GetInterpolationAlpha()); // Blend between the last two simulation states
+/// }
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// Headless processes can instead call Run(), which sleeps between steps until the next one is due. Sleeping uses the
+/// OS for all but the last part of the wait (as long as the OS's recent wake-up latency), which is spent yielding the
+/// thread, so steps start on time without spinning for the whole wait (see SleepUntil()).
+class FixedStepRunner
+{
+public:
+	/// Construct a runner for a task manager (the task manager must outlive the runner)
+	FixedStepRunner(TaskManager& in_taskMgr, tTaskClock::duration in_stepDuration, uint32_t in_maxStepsPerTick = 5)
+		: m_taskMgr(in_taskMgr)
+		, m_stepDuration(in_stepDuration)
+		, m_maxStepsPerTick(std::max(in_maxStepsPerTick, 1u))
+	{
+		SQUID_RUNTIME_CHECK(in_stepDuration > tTaskClock::duration::zero(), "Fixed step duration must be positive");
+	}
+
+	/// @brief Add the wall-clock time since the previous tick to the accumulator, and run every step that is due
+	/// @details The first tick only starts the clock. Returns the number of steps that were run.
+	uint32_t Tick()
+	{
+		tTaskClock::time_point now = tTaskClock::now();
+		tTaskClock::duration frameTime = m_lastTickTime ? now - m_lastTickTime.value() : tTaskClock::duration::zero();
+		m_lastTickTime = now;
+		return Tick(frameTime);
+	}
+
+	/// Add a given frame time to the accumulator, and run every step that is due (returns the number of steps that were run)
+	uint32_t Tick(tTaskClock::duration in_frameTime)
+	{
+		m_accumulatedTime += std::max(in_frameTime, tTaskClock::duration::zero());
+
+		// Drop any steps beyond the catch-up limit
+		tTaskClock::duration maxAccumulatedTime = m_stepDuration * m_maxStepsPerTick;
+		if(m_accumulatedTime > maxAccumulatedTime)
+		{
+			m_droppedTime += m_accumulatedTime - maxAccumulatedTime;
+			m_accumulatedTime = maxAccumulatedTime;
+		}
+
+		// Run each step that is due
+		uint32_t numSteps = 0;
+		while(m_accumulatedTime >= m_stepDuration)
+		{
+			m_accumulatedTime -= m_stepDuration;
+			Step();
+			++numSteps;
+		}
+		return numSteps;
+	}
+
+	/// Run a single step immediately (advancing the fixed-step time-stream by one step, then updating the task manager)
+	void Step()
+	{
+		++m_numSteps;
+		m_timeStream.SetTime(TaskTimeFromSeconds((double)m_numSteps * std::chrono::duration<double>(m_stepDuration).count())); // (No accumulated rounding error)
+		m_taskMgr.Update();
+	}
+
+	/// @brief Tick until the pre-tick function returns false (or Stop() is called), sleeping until each step is due
+	/// @details The pre-tick function is called before each tick (e.g. to update other time-streams).
+	void Run(std::function<bool()> in_preTickFn)
+	{
+		while(!m_isStopRequested && (!in_preTickFn || in_preTickFn()))
+		{
+			Tick();
+			if(!m_isStopRequested)
+			{
+				SleepUntil(m_lastTickTime.value() + (m_stepDuration - m_accumulatedTime));
+			}
+		}
+	}
+
+	/// Stop Run() after its current tick (thread-safe, and may be called before Run(), in which case Run() returns immediately)
+	void Stop()
+	{
+		m_isStopRequested = true;
+	}
+
+	/// @brief Sleep the calling thread until a given time
+	/// @details Sleeps via the OS until shortly before the deadline, then yields the thread until the deadline. How early
+	/// the OS sleep ends tracks how late OS sleeps have recently woken up, so little time is spent yielding.
+	void SleepUntil(tTaskClock::time_point in_deadline)
+	{
+		tTaskClock::time_point wakeTime = in_deadline - m_sleepOvershoot * 2; // (Headroom for wake-ups later than average)
+		tTaskClock::time_point now = tTaskClock::now();
+		if(wakeTime > now)
+		{
+			std::this_thread::sleep_for(wakeTime - now);
+			m_sleepOvershoot += (tTaskClock::now() - wakeTime - m_sleepOvershoot) / 8; // Moving average of the OS's wake-up latency
+		}
+		else
+		{
+			m_sleepOvershoot -= m_sleepOvershoot / 8; // Decay the estimate, so that one very late wake-up cannot cause lasting spinning
+		}
+		while(tTaskClock::now() < in_deadline)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	/// Returns a time function for the fixed-step time-stream (which advances by exactly one step per update)
+	auto GetTimeFn() const
+	{
+		return m_timeStream.GetTimeFn();
+	}
+
+	/// Returns the current time in the fixed-step time-stream
+	tTaskTime GetTime() const
+	{
+		return m_timeStream.GetTime();
+	}
+
+	/// Returns the fraction of a step that has accumulated towards the next step (from 0 to 1, e.g. for render interpolation)
+	double GetInterpolationAlpha() const
+	{
+		return std::chrono::duration<double>(m_accumulatedTime) / std::chrono::duration<double>(m_stepDuration);
+	}
+
+	/// Returns the number of steps that have been run
+	uint64_t GetNumSteps() const
+	{
+		return m_numSteps;
+	}
+
+	/// Returns the total wall-clock time that was dropped because more steps were due than the catch-up limit allowed
+	tTaskClock::duration GetDroppedTime() const
+	{
+		return m_droppedTime;
+	}
+
+private:
+	TaskManager& m_taskMgr;
+	VirtualTimeStream m_timeStream;
+	tTaskClock::duration m_stepDuration;
+	uint32_t m_maxStepsPerTick = 5;
+	tTaskClock::duration m_accumulatedTime = tTaskClock::duration::zero();
+	tTaskClock::duration m_droppedTime = tTaskClock::duration::zero();
+	tTaskClock::duration m_sleepOvershoot = std::chrono::microseconds(500); // Estimated OS wake-up latency
+	std::optional<tTaskClock::time_point> m_lastTickTime;
+	uint64_t m_numSteps = 0;
+	std::atomic<bool> m_isStopRequested = false;
 };
 
 NAMESPACE_SQUID_END
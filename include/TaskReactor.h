@@ -0,0 +1,283 @@
+#pragma once
+
+/// @defgroup TaskReactor Task Reactor
+/// @brief Linux epoll reactor that resumes tasks when file descriptors become ready.
+/// @{
+///
+/// A TaskReactor owns an epoll instance and offers awaiters that suspend a task until a file descriptor (e.g. a socket,
+/// pipe, eventfd or timerfd) is readable or writable. Waiting tasks are not polled: they are only resumed after the reactor
+/// has observed their file descriptor becoming ready, and the task manager treats them as asleep until then.
+///
+/// The reactor can either be polled once per frame (with a zero timeout) before updating a @ref TaskManager, or it can
+/// drive a task manager itself via @ref TaskReactor::Run(), in which case the thread blocks in epoll until a file
+/// descriptor is ready, the next timer deadline is reached (see @ref TaskManager::GetNextWakeTime()), or another thread
+/// calls @ref TaskReactor::Wake().
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+///
+/// Task<> EchoTask(TaskReactor& in_reactor, int in_fd)
+/// {
+/// 	char buf[256];
+/// 	while(true)
+/// 	{
+/// 		co_await in_reactor.WaitReadable(in_fd); // Sleeps until data arrives
+/// 		ssize_t numBytes = read(in_fd, buf, sizeof(buf));
+/// 		if(numBytes <= 0)
+/// 		{
+/// 			co_return;
+/// 		}
+/// 		co_await in_reactor.WaitWritable(in_fd);
+/// 		write(in_fd, buf, numBytes);
+/// 	}
+/// }
+///
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+/// The reactor (and its awaiters) must only be used from a single thread, with the exception of Wake() and Stop().
+/// This header is only available on Linux.
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "FunctionGuard.h"
+#include "TaskManager.h"
+
+NAMESPACE_SQUID_BEGIN
+
+//--- TaskReactor ---//
+/// Reactor that resumes tasks when file descriptors become ready (Linux epoll)
+class TaskReactor
+{
+public:
+	TaskReactor() /// Constructor (creates the epoll instance)
+	{
+		m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+		SQUID_RUNTIME_CHECK(m_epollFd >= 0, "Failed to create epoll instance");
+		m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		SQUID_RUNTIME_CHECK(m_wakeFd >= 0, "Failed to create reactor wake eventfd");
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = m_wakeFd;
+		epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+	}
+	~TaskReactor() /// Destructor (closes the epoll instance)
+	{
+		SQUID_NOTHROW_CHECK(m_fdEntries.empty(), "TaskReactor destroyed while tasks are still waiting on it");
+		close(m_wakeFd);
+		close(m_epollFd);
+	}
+	TaskReactor(const TaskReactor&) = delete;
+	TaskReactor& operator=(const TaskReactor&) = delete;
+
+	/// @brief Awaiter function that waits until a file descriptor is readable
+	/// @details Returns the epoll events that were observed (e.g. EPOLLIN, or EPOLLHUP/EPOLLERR if the descriptor was closed or failed).
+	Task<uint32_t> WaitReadable(int in_fd)
+	{
+		return WaitForEvents(in_fd, EPOLLIN);
+	}
+
+	/// @brief Awaiter function that waits until a file descriptor is writable
+	/// @details Returns the epoll events that were observed (e.g. EPOLLOUT, or EPOLLHUP/EPOLLERR if the descriptor was closed or failed).
+	Task<uint32_t> WaitWritable(int in_fd)
+	{
+		return WaitForEvents(in_fd, EPOLLOUT);
+	}
+
+	/// @brief Wait for file descriptors to become ready, and mark the tasks waiting on them as ready to resume
+	/// @details Blocks for at most @p in_timeout (or until woken, if no timeout is given). Returns the number of waiting
+	/// tasks that became ready.
+	size_t Poll(std::optional<tTaskClock::duration> in_timeout = tTaskClock::duration::zero())
+	{
+		int timeoutMs = -1;
+		if(in_timeout)
+		{
+			// Round up, so the reactor does not wake (and spin) just before a timer deadline
+			auto timeout = std::chrono::ceil<std::chrono::milliseconds>(std::max(in_timeout.value(), tTaskClock::duration::zero()));
+			timeoutMs = (int)std::min<int64_t>(timeout.count(), INT32_MAX);
+		}
+		epoll_event events[64];
+		int numEvents = epoll_wait(m_epollFd, events, 64, timeoutMs);
+		size_t numReady = 0;
+		for(int i = 0; i < numEvents; ++i)
+		{
+			int fd = events[i].data.fd;
+			if(fd == m_wakeFd)
+			{
+				uint64_t count;
+				while(read(m_wakeFd, &count, sizeof(count)) > 0) // Drain wake requests
+				{
+				}
+				continue;
+			}
+			numReady += OnFdEvents(fd, events[i].events);
+		}
+		return numReady;
+	}
+
+	/// @brief Update a task manager until the pre-update function returns false (or Stop() is called)
+	/// @details Between updates, the thread blocks in epoll until a file descriptor is ready, the next timer deadline is
+	/// reached, or the reactor is woken (while any task is waiting on a predicate, the reactor polls at @p in_pollInterval).
+	void Run(TaskManager& in_taskMgr, std::function<bool()> in_preUpdateFn, tTaskClock::duration in_pollInterval = std::chrono::milliseconds(10))
+	{
+		while(!m_isStopRequested && (!in_preUpdateFn || in_preUpdateFn()))
+		{
+			in_taskMgr.Update();
+			if(!m_isStopRequested)
+			{
+				Poll(TaskRunLoop::GetSleepTime(in_taskMgr.GetNextWakeTime(), in_pollInterval));
+			}
+		}
+	}
+
+	/// Wake the reactor if it is blocked in Poll() (thread-safe)
+	void Wake()
+	{
+		uint64_t one = 1;
+		ssize_t result = write(m_wakeFd, &one, sizeof(one));
+		(void)result; // The eventfd counter saturating just means a wake is already pending
+	}
+
+	/// Stop Run() after its current update (thread-safe, and may be called before Run(), in which case Run() returns immediately)
+	void Stop()
+	{
+		m_isStopRequested = true;
+		Wake();
+	}
+
+	/// Returns the number of file descriptors that tasks are currently waiting on
+	size_t GetNumWaitingFds() const
+	{
+		return m_fdEntries.size();
+	}
+
+private:
+	// Waiter (lives in the coroutine frame of the task waiting on the file descriptor)
+	struct FdWaiter
+	{
+		uint32_t events = 0; // Events being waited on
+		uint32_t readyEvents = 0; // Events observed (set once ready)
+	};
+
+	// File descriptor registration
+	struct FdEntry
+	{
+		std::vector<FdWaiter*> waiters; // Waiters that have not yet been made ready
+		uint32_t armedEvents = 0; // Events the descriptor is currently armed for (0 if disarmed)
+		bool isRegistered = false; // Whether the descriptor has been added to the epoll instance
+	};
+
+	Task<uint32_t> WaitForEvents(int in_fd, uint32_t in_events)
+	{
+		return [](TaskReactor* in_reactor, int in_fd, uint32_t in_events) -> Task<uint32_t> {
+			TASK_NAME("TaskReactor::WaitForEvents", [in_fd] { return "fd " + std::to_string(in_fd); });
+			FdWaiter waiter;
+			waiter.events = in_events;
+			in_reactor->AddWaiter(in_fd, &waiter);
+			auto removeWaiterGuard = MakeFnGuard([&] {
+				in_reactor->RemoveWaiter(in_fd, &waiter); // Runs if the task is killed while waiting
+			});
+			co_await ExternalReadyFn{ [&waiter] { return waiter.readyEvents != 0; } };
+			co_return waiter.readyEvents;
+		}(this, in_fd, in_events);
+	}
+	void AddWaiter(int in_fd, FdWaiter* in_waiter)
+	{
+		FdEntry& entry = m_fdEntries[in_fd];
+		entry.waiters.push_back(in_waiter);
+		ArmFd(in_fd, entry);
+	}
+	void RemoveWaiter(int in_fd, FdWaiter* in_waiter)
+	{
+		auto foundIter = m_fdEntries.find(in_fd);
+		if(foundIter == m_fdEntries.end())
+		{
+			return;
+		}
+		FdEntry& entry = foundIter->second;
+		entry.waiters.erase(std::remove(entry.waiters.begin(), entry.waiters.end(), in_waiter), entry.waiters.end());
+		if(entry.waiters.empty())
+		{
+			epoll_ctl(m_epollFd, EPOLL_CTL_DEL, in_fd, nullptr); // May fail harmlessly if the descriptor was already closed
+			m_fdEntries.erase(foundIter);
+		}
+		else
+		{
+			ArmFd(in_fd, entry);
+		}
+	}
+	void ArmFd(int in_fd, FdEntry& io_entry)
+	{
+		// Arm the descriptor (one-shot) for the union of the events its waiters are waiting on
+		uint32_t events = 0;
+		for(const FdWaiter* waiter : io_entry.waiters)
+		{
+			events |= waiter->events;
+		}
+		if(events == io_entry.armedEvents)
+		{
+			return;
+		}
+		epoll_event event = {};
+		event.events = events | EPOLLONESHOT;
+		event.data.fd = in_fd;
+		int result = epoll_ctl(m_epollFd, io_entry.isRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, in_fd, &event);
+		SQUID_RUNTIME_CHECK(result == 0, "Failed to register file descriptor with epoll");
+		io_entry.isRegistered = true;
+		io_entry.armedEvents = events;
+	}
+	size_t OnFdEvents(int in_fd, uint32_t in_events)
+	{
+		auto foundIter = m_fdEntries.find(in_fd);
+		if(foundIter == m_fdEntries.end())
+		{
+			return 0;
+		}
+
+		// Make ready every waiter whose events occurred (errors and hang-ups make all waiters ready)
+		FdEntry& entry = foundIter->second;
+		entry.armedEvents = 0; // One-shot descriptors are disarmed once they report events
+		size_t numReady = 0;
+		uint32_t readyMask = (in_events & (EPOLLERR | EPOLLHUP)) ? ~0u : in_events;
+		entry.waiters.erase(std::remove_if(entry.waiters.begin(), entry.waiters.end(), [&](FdWaiter* in_waiter) {
+			if(in_waiter->events & readyMask)
+			{
+				in_waiter->readyEvents = in_events;
+				++numReady;
+				return true;
+			}
+			return false;
+		}), entry.waiters.end());
+
+		// Re-arm the descriptor for any remaining waiters
+		if(entry.waiters.empty())
+		{
+			epoll_ctl(m_epollFd, EPOLL_CTL_DEL, in_fd, nullptr);
+			m_fdEntries.erase(foundIter);
+		}
+		else
+		{
+			ArmFd(in_fd, entry);
+		}
+		return numReady;
+	}
+
+	int m_epollFd = -1;
+	int m_wakeFd = -1;
+	std::unordered_map<int, FdEntry> m_fdEntries; // Descriptors with waiting tasks
+	std::atomic<bool> m_isStopRequested = false;
+};
+
+NAMESPACE_SQUID_END
+
+#endif // defined(__linux__)
+
+///@} end of TaskReactor group
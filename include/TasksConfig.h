@@ -19,6 +19,11 @@
 #define SQUID_ENABLE_DOUBLE_PRECISION_TIME 0
 #endif
 
+/// Switches time type (tTaskTime) to 64-bit integer ticks, with this many ticks per second (e.g. 1000000000 for nanoseconds) [see @ref TaskTimeFromSeconds()]
+#ifndef SQUID_TIME_TICKS
+#define SQUID_TIME_TICKS 0
+#endif
+
 /// Wraps a Squid:: namespace around all classes in the Squid::Tasks library
 #ifndef SQUID_ENABLE_NAMESPACE
 #define SQUID_ENABLE_NAMESPACE 0
@@ -29,6 +34,31 @@
 #define SQUID_USE_EXCEPTIONS 0
 #endif
 
+/// Allocates coroutine frames from per-thread pools that can be filled ahead of time (see @ref ReserveTaskFrames())
+#ifndef SQUID_ENABLE_TASK_FRAME_POOL
+#define SQUID_ENABLE_TASK_FRAME_POOL 0
+#endif
+
+/// Measures update budgets and resume deadlines with the CPU timestamp counter instead of std::chrono::steady_clock [see @ref FastClock]
+#ifndef SQUID_ENABLE_FAST_CLOCK
+#define SQUID_ENABLE_FAST_CLOCK 0
+#endif
+
+/// Uses SSE2 intrinsics (where the target supports them) for batch evaluations, such as polled timers [see @ref PolledTimeStream]
+#ifndef SQUID_ENABLE_SIMD
+#define SQUID_ENABLE_SIMD 1
+#endif
+
+/// Stores a debug name in each token [see @ref TokenName] (when disabled, token names are compiled out)
+#ifndef SQUID_ENABLE_TOKEN_NAMES
+#define SQUID_ENABLE_TOKEN_NAMES SQUID_ENABLE_TASK_DEBUG
+#endif
+
+/// Allocates tokens (together with their shared_ptr control blocks) from per-thread pools instead of the global heap (over-aligned tokens are allocated directly)
+#ifndef SQUID_ENABLE_TOKEN_POOL
+#define SQUID_ENABLE_TOKEN_POOL 1
+#endif
+
 /// Enables global time support(alleviating the need to specify a time stream for time - sensitive awaiters) [see @ref GetGlobalTime()]
 #ifndef SQUID_ENABLE_GLOBAL_TIME
 // ***************
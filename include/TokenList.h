@@ -8,10 +8,10 @@
 /// new Token can then be added to the TokenList using @ref TokenList::AddToken(). @ref TokenList::TakeToken() 
 /// can be used to make + add a new token with a single function call.
 /// 
-/// Because TokenList uses weak pointers to track its elements, Token objects are logically removed from the list once
-/// they are destroyed. As such, it is usually unnecessary to explicitly call @ref TokenList::RemoveToken() to remove a
-/// Token from the list. Instead, it is idiomatic to consider the Token to be a sort of "scope guard" that will remove
-/// itself from all TokenList objects when it leaves scope.
+/// Each Token keeps a back-link to its entry in every TokenList it belongs to, and removes itself from those lists when
+/// it is destroyed (adding, removing and expiring tokens are all O(1) operations). As such, it is usually unnecessary to
+/// explicitly call @ref TokenList::RemoveToken() to remove a Token from the list. Instead, it is idiomatic to consider
+/// the Token to be a sort of "scope guard" that will remove itself from all TokenList objects when it leaves scope.
 /// 
 /// The TokenList class is included as part of Squid::Tasks to provide a simple mechanism for robustly sharing aribtrary
 /// state between multiple tasks. Consider this example of a poison damage-over-time system:
@@ -56,299 +56,2616 @@
 /// As the above example shows, this mechanism is well-suited for coroutines, as they can hold a Token across 
 /// multiple frames. Also note that Token objects can optionally hold data. The TokenList class has query functions
 /// (e.g. GetMin()/GetMax()) that can be used to aggregate the data from the set of live tokens. This is used above
-/// to quickly find the highest DPS poison instance.
+/// to quickly find the highest DPS poison instance. Because lists aggregate it, a token's data can no longer be written
+/// directly (DataToken::data has been replaced by the read-only DataToken::GetData()). Instead, it is changed using
+/// @ref TokenList::SetData(), which updates every list the token belongs to.
+/// 
+/// Tasks can also wait for the set of live tokens to change, using @ref TokenListBase::WaitUntilHasTokens(),
+/// @ref TokenListBase::WaitUntilEmpty() or @ref TokenListBase::WaitForChange(). A waiting task is treated as asleep by its
+/// task manager until a token is added, removed or expires, rather than polling the list every frame. As nothing wakes
+/// a sleeping task's scheduler when the list changes, tokens must be added and released on the thread that updates the
+/// waiting task (as with all TokenList access; see @ref ConcurrentTokenList for lists changed by other threads):
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// co_await m_stunTokens.WaitUntilEmpty(); // Resumes as soon as the last stun token is released
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// Effects that simply last for a fixed duration do not need a task to hold their token at all. The container can hold
+/// the token itself, and release it once the duration has elapsed in a @ref TimeStream:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// m_poisonTokens.TakeTokenFor(__FUNCTION__, in_dps, TaskTimeFromSeconds(in_duration), m_gameTime);
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// Where a set of tokens without data only ever needs to answer "are there any tokens?", a @ref TokenCounter is a
+/// cheaper alternative to TokenList<>. Its tokens are @ref CountedToken scope guards that increment and decrement a
+/// counter, with no allocation.
+/// 
+/// Where many small lists hold arithmetic data (e.g. a speed multiplier list per entity) and a system queries every list
+/// each frame, a @ref TokenRegistry stores the data of every list in shared contiguous columns, and evaluates the min,
+/// max or sum of all of its lists in one pass.
+/// 
+/// TokenList is not thread-safe. Destroying a token removes it from every list it belongs to, so the last reference to
+/// a token (e.g. a std::shared_ptr captured by a callback) must be released on the thread that owns those lists. Tokens
+/// that are taken and released on worker threads (e.g. "loading in progress" tokens held by background jobs) should
+/// instead use a @ref ConcurrentTokenList, whose aggregates are queried on a @ref TokenSnapshot.
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <numeric>
-#include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
-//--- User configuration header ---//
-#include "TasksConfig.h"
+#include "FunctionGuard.h"
+#include "Task.h"
 
 NAMESPACE_SQUID_BEGIN
 
 template <typename T = void>
 class TokenList;
+class TokenListBase;
+class TokenBase;
 
-/// @brief Handle to a TokenList element that stores a debug name
-/// @details In most circumstances, name should be set to \ref __FUNCTION__ at the point of creation.
-struct Token
+/// @private Strings that a token name cannot point to without interning (anything convertible to a string, other than a const char array)
+template <typename tString, typename tBare = std::remove_reference_t<tString>>
+using IsNonLiteralTokenName = std::bool_constant<std::is_convertible<tString, std::string_view>::value &&
+	!(std::is_array<tBare>::value && std::is_const<std::remove_extent_t<tBare>>::value)>;
+
+/// @brief Debug name of a token, which never allocates when it is made from a string literal (or \c __FUNCTION__)
+/// @details A name made from a string literal stores just the pointer. Any other string (e.g. a std::string, a char
+/// buffer or a pointer) must be interned explicitly with TokenName::Intern(), which copies it once into a process-wide
+/// table (shared by every later name with the same text) behind a lock. Avoid interning unbounded sets of generated names
+/// (e.g. per-entity IDs), as interned strings are never freed. When SQUID_ENABLE_TOKEN_NAMES is disabled, names are
+/// compiled out entirely (and hold no data).
+class TokenName
 {
-	Token(std::string in_name)
-		: name(std::move(in_name))
+public:
+	TokenName() = default; /// Default constructor (empty name)
+	template <size_t N>
+	TokenName(const char (&in_name)[N]) /// Constructor (stores a pointer to a string literal)
+		: TokenName(in_name, StaticString{})
 	{
 	}
-	std::string name; // Used for debug only
-};
+	template <typename tString, typename std::enable_if_t<IsNonLiteralTokenName<tString>::value>* = nullptr>
+	TokenName(tString&&) /// @private Illegal non-literal string implementation
+	{
+		static_assert(static_false<tString>::value, "Token names must be string literals (use TokenName::Intern() to name a token with any other string)");
+	}
 
-/// @brief Handle to a TokenList element that stores both a debug name and associated data
-/// @details In most circumstances, name should be set to \c __FUNCTION__ at the point of creation.
-template <typename tData>
-struct DataToken
-{
-	DataToken(std::string in_name, tData in_data)
-		: name(std::move(in_name))
-		, data(std::move(in_data))
+	/// Returns a name that points to an interned copy of a string (which is never freed)
+	static TokenName Intern(std::string_view in_name)
 	{
+#if SQUID_ENABLE_TOKEN_NAMES
+		static std::mutex s_mutex;
+		static std::unordered_set<std::string> s_names; // (Node-based, so interned strings never move)
+		std::lock_guard<std::mutex> lock(s_mutex);
+		return TokenName(s_names.emplace(in_name).first->c_str(), StaticString{});
+#else
+		(void)in_name;
+		return TokenName();
+#endif //SQUID_ENABLE_TOKEN_NAMES
 	}
-	std::string name; // Used for debug only
-	tData data;
-};
 
-/// Create a token with the specified debug name
-inline std::shared_ptr<Token> MakeToken(std::string in_name)
-{
-	return std::make_shared<Token>(std::move(in_name));
-}
+	/// Returns the name as a C string
+	const char* GetString() const
+	{
+#if SQUID_ENABLE_TOKEN_NAMES
+		return m_name ? m_name : "";
+#else
+		return "[unnamed]";
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	}
 
-/// Create a token with the specified debug name and associated data
-template <typename tData>
-std::shared_ptr<DataToken<tData>> MakeToken(std::string in_name, tData in_data)
-{
-	return std::make_shared<DataToken<tData>>(std::move(in_name), std::move(in_data));
-}
+private:
+	struct StaticString // Tags a string that outlives every name (a literal, or an interned string)
+	{
+	};
+	TokenName(const char* in_name, StaticString)
+#if SQUID_ENABLE_TOKEN_NAMES
+		: m_name(in_name)
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	{
+		(void)in_name;
+	}
 
-/// @brief Container for tracking decentralized state across multiple tasks. (See \ref Tokens for more info...)
-/// @tparam T Type of data to associate with each Token in this container
-template <typename T>
-class TokenList
+#if SQUID_ENABLE_TOKEN_NAMES
+	const char* m_name = nullptr;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+};
+
+#if SQUID_ENABLE_TOKEN_POOL
+/// @private Per-thread free lists of token allocations (each holding a token and its shared_ptr control block), bucketed by size class
+class TokenPool
 {
 public:
-	/// Type of Token tracked by this container
-	using Token = typename std::conditional_t<std::is_void<T>::value, Token, DataToken<T>>;
+	static constexpr size_t k_sizeClassBytes = 16;
+	static constexpr size_t k_numSizeClasses = 16; // Tokens larger than 256 bytes are allocated directly
 
-	/// Create a token with the specified debug name
-	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
-	static std::shared_ptr<Token> MakeToken(std::string in_name)
+	static void* Allocate(size_t in_size)
 	{
-		return std::make_shared<Token>(std::move(in_name));
+		size_t sizeClass = GetSizeClass(in_size);
+		Pools* pools = GetPools();
+		if(sizeClass < k_numSizeClasses && pools && pools->freeLists[sizeClass])
+		{
+			FreeBlock* block = pools->freeLists[sizeClass];
+			pools->freeLists[sizeClass] = block->next;
+			return block;
+		}
+		return ::operator new(sizeClass < k_numSizeClasses ? (sizeClass + 1) * k_sizeClassBytes : in_size);
 	}
-
-	/// Create a token with the specified debug name and associated data
-	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
-	static std::shared_ptr<Token> MakeToken(std::string in_name, U in_data)
+	static void Free(void* in_ptr, size_t in_size) noexcept
 	{
-		return std::make_shared<Token>(std::move(in_name), std::move(in_data));
+		size_t sizeClass = GetSizeClass(in_size);
+		Pools* pools = GetPools();
+		if(sizeClass < k_numSizeClasses && pools)
+		{
+			// Blocks are allocated individually, so a block freed on a different thread simply joins that thread's pool
+			FreeBlock* block = static_cast<FreeBlock*>(in_ptr);
+			block->next = pools->freeLists[sizeClass];
+			pools->freeLists[sizeClass] = block;
+			return;
+		}
+		::operator delete(in_ptr);
 	}
 
-	/// Create and add a token with the specified debug name
-	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
-	SQUID_NODISCARD std::shared_ptr<Token> TakeToken(std::string in_name)
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+	struct Pools
+	{
+		~Pools()
+		{
+			IsDestroyed() = true; // Tokens freed after this thread's pools are destroyed are deleted directly
+			for(FreeBlock* freeList : freeLists)
+			{
+				while(freeList)
+				{
+					FreeBlock* next = freeList->next;
+					::operator delete(freeList);
+					freeList = next;
+				}
+			}
+		}
+		FreeBlock* freeLists[k_numSizeClasses] = {};
+	};
+	static bool& IsDestroyed()
 	{
-		return AddTokenInternal(MakeToken(std::move(in_name)));
+		thread_local bool s_isDestroyed = false;
+		return s_isDestroyed;
 	}
-
-	/// Create and add a token with the specified debug name and associated data
-	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
-	SQUID_NODISCARD std::shared_ptr<Token> TakeToken(std::string in_name, U in_data)
+	static Pools* GetPools()
 	{
-		return AddTokenInternal(MakeToken(std::move(in_name), std::move(in_data)));
+		if(IsDestroyed())
+		{
+			return nullptr;
+		}
+		thread_local Pools s_pools;
+		return &s_pools;
 	}
-
-	/// Add an existing token to this container
-	std::shared_ptr<Token> AddToken(std::shared_ptr<Token> in_token)
+	static size_t GetSizeClass(size_t in_size)
 	{
-		SQUID_RUNTIME_CHECK(in_token, "Cannot add null token");
-		auto foundIter = std::find_if(m_tokens.begin(), m_tokens.end(), [&in_token](const std::weak_ptr<Token> in_iterToken){ 
-			return in_iterToken.lock() == in_token; 
-		});
+		return (in_size - 1) / k_sizeClassBytes;
+	}
+};
+
+/// @private Allocator that takes tokens from the calling thread's TokenPool (used with std::allocate_shared)
+/// @details Over-aligned tokens are not pooled, and are allocated directly with their required alignment.
+template <typename T>
+struct TokenPoolAllocator
+{
+	using value_type = T;
 
-		if(foundIter == m_tokens.end()) // Prevent duplicate tokens
+	TokenPoolAllocator() = default;
+	template <typename U>
+	TokenPoolAllocator(const TokenPoolAllocator<U>&) noexcept
+	{
+	}
+	T* allocate(size_t in_num)
+	{
+		if constexpr(alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
 		{
-			return AddTokenInternal(in_token);
+			return static_cast<T*>(::operator new(in_num * sizeof(T), std::align_val_t(alignof(T))));
+		}
+		else
+		{
+			return static_cast<T*>(TokenPool::Allocate(in_num * sizeof(T)));
 		}
-		return in_token;
 	}
-
-	/// Explicitly remove a token from this container
-	void RemoveToken(std::shared_ptr<Token> in_token)
+	void deallocate(T* in_ptr, size_t in_num) noexcept
 	{
-		// Find and remove the token
-		if(m_tokens.size())
+		if constexpr(alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
 		{
-			m_tokens.erase(std::remove_if(m_tokens.begin(), m_tokens.end(), [&in_token](const std::weak_ptr<Token>& in_otherToken) {
-				return !in_otherToken.owner_before(in_token) && !in_token.owner_before(in_otherToken);
-			}), m_tokens.end());
+			::operator delete(in_ptr, std::align_val_t(alignof(T)));
 		}
+		else
+		{
+			TokenPool::Free(in_ptr, in_num * sizeof(T));
+		}
+	}
+	template <typename U>
+	bool operator==(const TokenPoolAllocator<U>&) const noexcept
+	{
+		return true;
+	}
+	template <typename U>
+	bool operator!=(const TokenPoolAllocator<U>&) const noexcept
+	{
+		return false;
+	}
+};
+#endif //SQUID_ENABLE_TOKEN_POOL
+
+/// @private Creates a shared token (taken from the calling thread's token pool, if SQUID_ENABLE_TOKEN_POOL is set)
+template <typename tToken, typename... tArgs>
+std::shared_ptr<tToken> MakeSharedToken(tArgs&&... in_args)
+{
+#if SQUID_ENABLE_TOKEN_POOL
+	return std::allocate_shared<tToken>(TokenPoolAllocator<tToken>(), std::forward<tArgs>(in_args)...);
+#else
+	return std::make_shared<tToken>(std::forward<tArgs>(in_args)...);
+#endif //SQUID_ENABLE_TOKEN_POOL
+}
+
+/// @private Membership of a token in a token list (lets the token and the list find each other in O(1))
+struct TokenLink
+{
+	TokenListBase* list = nullptr; // List the token belongs to (null if unused)
+	size_t idx = SIZE_MAX; // Index of the token's entry in the list
+};
+
+/// @private Base class of tokens, which tracks the lists each token belongs to (so it can remove itself when destroyed)
+class TokenBase
+{
+public:
+	TokenBase(TokenName in_name)
+		: name(in_name)
+	{
 	}
+	TokenBase(const TokenBase&) = delete; // Lists refer to tokens by address
+	TokenBase& operator=(const TokenBase&) = delete;
 
-	/// Convenience conversion operator that calls HasTokens()
-	operator bool() const
+	TokenName name; // Used for debug only
+
+protected:
+	~TokenBase()
 	{
-		return HasTokens();
+		SQUID_NOTHROW_CHECK(!m_link.list && m_extraLinks.empty(), "Token destroyed without being removed from its lists");
 	}
+	void RemoveFromLists(); // Removes the token from every list it belongs to (called by derived destructors, while the token's data is still alive)
 
-	/// Returns whether this container holds any live tokens
-	bool HasTokens() const
+private:
+	friend class TokenListBase;
+	TokenLink* FindLink(const TokenListBase* in_list)
 	{
-		// Return true when holding any unexpired tokens
-		for(auto i = (int32_t)(m_tokens.size() - 1); i >= 0; --i)
+		if(m_link.list == in_list)
+		{
+			return &m_link;
+		}
+		for(TokenLink& link : m_extraLinks)
 		{
-			const auto& token = m_tokens[i];
-			if(!token.expired())
+			if(link.list == in_list)
 			{
-				return true;
+				return &link;
 			}
-			m_tokens.pop_back(); // Because the token is expired, we can safely remove it from the back
 		}
-		return false;
+		return nullptr;
 	}
-
-	/// Returns an array of all live token data
-	std::vector<T> GetTokenData() const
+	void AddLink(TokenListBase* in_list, size_t in_idx)
 	{
-		std::vector<T> tokenData;
-		for(const auto& tokenWeak : m_tokens)
+		if(!m_link.list)
+		{
+			m_link = { in_list, in_idx };
+		}
+		else
+		{
+			m_extraLinks.push_back({ in_list, in_idx });
+		}
+	}
+	void RemoveLink(const TokenListBase* in_list)
+	{
+		if(m_link.list == in_list)
+		{
+			m_link = {};
+			if(!m_extraLinks.empty())
+			{
+				m_link = m_extraLinks.back();
+				m_extraLinks.pop_back();
+			}
+			return;
+		}
+		for(size_t i = 0; i < m_extraLinks.size(); ++i)
 		{
-			if(auto token = tokenWeak.lock())
+			if(m_extraLinks[i].list == in_list)
 			{
-				tokenData.push_back(token->data);
+				m_extraLinks[i] = m_extraLinks.back();
+				m_extraLinks.pop_back();
+				return;
 			}
 		}
-		return tokenData;
 	}
 
-	/// @name Data Queries
-	/// Methods for querying and aggregating the data from the set of live tokens.
-	/// @{
-	
-	/// Returns associated data from the least-recently-added live token
-	std::optional<T> GetLeastRecent() const
+	TokenLink m_link; // First list membership (stored inline, as most tokens belong to a single list)
+	std::vector<TokenLink> m_extraLinks; // Any further list memberships
+};
+
+/// @brief Handle to a TokenList element that stores a debug name
+/// @details In most circumstances, name should be set to \ref __FUNCTION__ at the point of creation. Destroying the
+/// token removes it from its lists, so the last reference to it must be released on the thread that owns those lists.
+struct Token : public TokenBase
+{
+	Token(TokenName in_name)
+		: TokenBase(in_name)
 	{
-		Sanitize();
-		return m_tokens.size() ? m_tokens.front().lock()->data : std::optional<T>{};
 	}
+	~Token()
+	{
+		RemoveFromLists();
+	}
+};
 
-	/// Returns associated data from the most-recently-added live token
-	std::optional<T> GetMostRecent() const
+/// @brief Handle to a TokenList element that stores both a debug name and associated data
+/// @details In most circumstances, name should be set to \c __FUNCTION__ at the point of creation. Destroying the
+/// token removes it from its lists, so the last reference to it must be released on the thread that owns those lists.
+/// The data is read with GetData(), and can only be changed with @ref TokenList::SetData().
+template <typename tData>
+struct DataToken : public TokenBase
+{
+	DataToken(TokenName in_name, tData in_data)
+		: TokenBase(in_name)
+		, m_data(std::move(in_data))
 	{
-		Sanitize();
-		return m_tokens.size() ? m_tokens.back().lock()->data : std::optional<T>{};
+	}
+	~DataToken()
+	{
+		RemoveFromLists();
 	}
 
-	/// Returns smallest associated data from the set of live tokens
-	std::optional<T> GetMin() const
+	/// Returns the associated data (read-only, as containers aggregate it; change it with TokenList::SetData())
+	const tData& GetData() const
+	{
+		return m_data;
+	}
+
+private:
+	template <typename> friend class TokenList;
+	tData m_data;
+};
+
+/// Create a token with the specified debug name
+inline std::shared_ptr<Token> MakeToken(TokenName in_name)
+{
+	return MakeSharedToken<Token>(in_name);
+}
+
+/// Create a token with the specified debug name and associated data
+template <typename tData>
+std::shared_ptr<DataToken<tData>> MakeToken(TokenName in_name, tData in_data)
+{
+	return MakeSharedToken<DataToken<tData>>(in_name, std::move(in_data));
+}
+
+/// @brief Untyped base class of TokenList, which stores the live tokens and implements the awaiter functions
+/// @details Entries are stored in an unordered array (for O(1) swap-removal), threaded with a doubly-linked list in the
+/// order the tokens were added (for least/most-recent queries).
+class TokenListBase
+{
+public:
+	TokenListBase() = default;
+	virtual ~TokenListBase()
+	{
+		RemoveAllEntries();
+		for(Waiter* waiter : m_waiters)
+		{
+			waiter->list = nullptr; // Resumes the waiting task
+		}
+	}
+	TokenListBase(const TokenListBase&) = delete;
+	TokenListBase& operator=(const TokenListBase&) = delete;
+
+	/// @brief Awaiter function that waits until the container holds at least one live token
+	/// @details The waiting task is treated as asleep by its task manager until a token is added. Also resumes if the
+	/// container is destroyed. Tokens must be added on the thread that updates the waiting task, as nothing wakes its
+	/// scheduler (e.g. a sleeping @ref TaskRunLoop) when the container changes.
+	Task<> WaitUntilHasTokens()
+	{
+		return WaitForState(this, eWaitType::HasTokens);
+	}
+
+	/// @brief Awaiter function that waits until the container holds no live tokens
+	/// @details The waiting task is treated as asleep by its task manager until the last token is removed or expires.
+	/// Also resumes if the container is destroyed. Tokens must be released on the thread that updates the waiting task,
+	/// as nothing wakes its scheduler (e.g. a sleeping @ref TaskRunLoop) when the container changes.
+	Task<> WaitUntilEmpty()
+	{
+		return WaitForState(this, eWaitType::Empty);
+	}
+
+	/// @brief Awaiter function that waits until a token is added to (or removed from) the container
+	/// @details Always waits for the next change (even if the container changed earlier in the same frame). The waiting
+	/// task is treated as asleep by its task manager until then. Also resumes if the container is destroyed. Tokens
+	/// must be added and released on the thread that updates the waiting task, as nothing wakes its scheduler (e.g. a
+	/// sleeping @ref TaskRunLoop) when the container changes.
+	Task<> WaitForChange()
+	{
+		return WaitForState(this, eWaitType::Change);
+	}
+
+protected:
+	struct Entry
+	{
+		TokenBase* token = nullptr;
+		size_t prevIdx = SIZE_MAX; // Previous (less-recently-added) entry
+		size_t nextIdx = SIZE_MAX; // Next (more-recently-added) entry
+	};
+
+	enum class eWaitType
+	{
+		HasTokens,
+		Empty,
+		Change,
+	};
+
+	// Waiter (lives in the coroutine frame of the task waiting on the list)
+	struct Waiter
 	{
-		std::optional<T> ret;
-		SanitizeAndProcessData([&ret](const T& in_data) {
-			if(!ret || in_data < ret.value())
+		const TokenListBase* list = nullptr; // (Cleared if the list is destroyed)
+		eWaitType waitType = eWaitType::Change;
+		uint64_t numChanges = 0; // Number of changes to the list when the wait began
+
+		bool IsReady() const
+		{
+			if(!list)
 			{
-				ret = in_data;
+				return true;
 			}
-		});
-		return ret;
-	}
+			list->ExpireTimedTokens();
+			switch(waitType)
+			{
+			case eWaitType::HasTokens:
+				return !list->m_entries.empty();
+			case eWaitType::Empty:
+				return list->m_entries.empty();
+			default:
+				return list->m_numChanges != numChanges;
+			}
+		}
+	};
 
-	/// Returns largest associated data from the set of live tokens
-	std::optional<T> GetMax() const
+	static Task<> WaitForState(TokenListBase* in_list, eWaitType in_waitType)
 	{
-		std::optional<T> ret;
-		SanitizeAndProcessData([&ret](const T& in_data) {
-			if(!ret || in_data > ret.value())
+		TASK_NAME("TokenList::WaitForState");
+		Waiter waiter{ in_list, in_waitType, in_list->m_numChanges };
+		if(in_waitType != eWaitType::Change && waiter.IsReady())
+		{
+			co_return;
+		}
+		in_list->m_waiters.push_back(&waiter);
+		auto removeWaiterGuard = MakeFnGuard([&waiter] {
+			if(waiter.list) // Runs once the wait is over (or if the task is killed while waiting)
 			{
-				ret = in_data;
+				auto& waiters = const_cast<TokenListBase*>(waiter.list)->m_waiters;
+				waiters.erase(std::remove(waiters.begin(), waiters.end(), &waiter), waiters.end());
 			}
 		});
-		return ret;
+		while(!waiter.IsReady())
+		{
+			if(!waiter.list->HasTimedTokens())
+			{
+				// Token changes must be made on the waiting task's own thread (see WaitUntilEmpty()), so no external wake is needed
+				co_await ExternalReadyFn{ [&waiter] { return waiter.IsReady() || waiter.list->HasTimedTokens(); } };
+			}
+			else
+			{
+				// Timed tokens expire as time passes, so the scheduler must poll the list while any are live
+				co_await tTaskReadyFn([&waiter] { return waiter.IsReady() || !waiter.list->HasTimedTokens(); });
+			}
+		}
 	}
 
-	/// Returns arithmetic mean of all associated data from the set of live tokens
-	std::optional<double> GetMean() const
+	// Timed tokens (held by the list until their deadline passes in a time-stream)
+	struct TimedToken
+	{
+		tTaskTime deadline;
+		std::shared_ptr<TokenBase> token;
+	};
+	struct TimedTokenQueue
 	{
-		std::optional<double> ret;
-		std::optional<double> total;
-		SanitizeAndProcessData([&total](const T& in_data) {
-			total = total.value_or(0.0) + (double)in_data;
+		const TimeStream* timeStream = nullptr;
+		std::vector<TimedToken> timedTokens; // Binary min-heap, ordered by deadline
+	};
+	void AddTimedToken(std::shared_ptr<TokenBase> in_token, tTaskTime in_duration, const TimeStream& in_timeStream)
+	{
+		auto foundIter = std::find_if(m_timedTokenQueues.begin(), m_timedTokenQueues.end(), [&in_timeStream](const TimedTokenQueue& in_queue) {
+			return in_queue.timeStream == &in_timeStream;
 		});
-		if(total)
+		if(foundIter == m_timedTokenQueues.end())
 		{
-			ret = total.value() / m_tokens.size();
+			foundIter = m_timedTokenQueues.insert(m_timedTokenQueues.end(), { &in_timeStream, {} });
 		}
-		return ret;
+		foundIter->timedTokens.push_back({ in_timeStream.GetTime() + in_duration, std::move(in_token) });
+		std::push_heap(foundIter->timedTokens.begin(), foundIter->timedTokens.end(), IsLaterDeadline);
 	}
-
-	/// Returns whether the set of live tokens contains at least one token associated with the specified data
-	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
-	bool Contains(const U& in_searchData) const
+	bool HasTimedTokens() const
+	{
+		return !m_timedTokenQueues.empty();
+	}
+	void ExpireTimedTokens() const // Removes (and releases) every timed token whose deadline has passed
 	{
-		bool containsData = false;
-		SanitizeAndProcessData([&in_searchData, &containsData](const T& in_data) {
-			if(in_searchData == in_data)
+		if(m_timedTokenQueues.empty())
+		{
+			return;
+		}
+		auto* self = const_cast<TokenListBase*>(this); // (Expiry is logically part of the list's state, so queries may apply it)
+		for(size_t queueIdx = 0; queueIdx < self->m_timedTokenQueues.size();)
+		{
+			// Pop tokens in deadline order (releasing a token may remove it from other lists, but never from this queue)
+			TimedTokenQueue& queue = self->m_timedTokenQueues[queueIdx];
+			tTaskTime time = queue.timeStream->GetTime();
+			while(queue.timedTokens.size() && queue.timedTokens.front().deadline <= time)
 			{
-				containsData = true;
+				std::pop_heap(queue.timedTokens.begin(), queue.timedTokens.end(), IsLaterDeadline);
+				std::shared_ptr<TokenBase> token = std::move(queue.timedTokens.back().token);
+				queue.timedTokens.pop_back();
+				self->RemoveEntry(token.get());
 			}
-		});
-		return containsData;
+			if(queue.timedTokens.empty())
+			{
+				self->m_timedTokenQueues.erase(self->m_timedTokenQueues.begin() + queueIdx);
+			}
+			else
+			{
+				++queueIdx;
+			}
+		}
+	}
+	static bool IsLaterDeadline(const TimedToken& in_a, const TimedToken& in_b)
+	{
+		return in_b.deadline < in_a.deadline;
 	}
-	///@} end of Data Queries
 
-	/// Returns a debug string containing a list of the debug names of all live tokens
-	std::string GetDebugString() const 
+	bool ContainsEntry(const TokenBase* in_token) const
 	{
-		std::vector<std::string> tokenStrings;
-		std::string debugStr;
-		for(const auto& token : m_tokens) 
+		return const_cast<TokenBase*>(in_token)->FindLink(this) != nullptr;
+	}
+	void AddEntry(TokenBase* in_token)
+	{
+		size_t idx = m_entries.size();
+		m_entries.push_back({ in_token, m_newestIdx, SIZE_MAX });
+		if(m_newestIdx != SIZE_MAX)
 		{
-			if(!token.expired())
-			{
-				if(debugStr.size() > 0)
-				{
-					debugStr += "\n";
-				}
-				debugStr += token.lock()->name;
-			}
+			m_entries[m_newestIdx].nextIdx = idx;
 		}
-		if(debugStr.size() == 0)
+		else
 		{
-			debugStr = "[no tokens]";
+			m_oldestIdx = idx;
 		}
-		return debugStr;
+		m_newestIdx = idx;
+		in_token->AddLink(this, idx);
+		++m_numChanges;
 	}
-
-private:
-	// Shared internal implementation for adding tokens
-	std::shared_ptr<Token> AddTokenInternal(std::shared_ptr<Token> in_token)
+	void RemoveEntry(TokenBase* in_token)
 	{
-		Sanitize();
-		m_tokens.push_back(in_token);
-		return in_token;
+		if(TokenLink* link = in_token->FindLink(this))
+		{
+			size_t idx = link->idx;
+			in_token->RemoveLink(this);
+			RemoveEntryAt(idx);
+		}
 	}
-
-	// Sanitation
-	void Sanitize() const
+	void RemoveAllEntries()
 	{
-		// Remove all invalid tokens
-		if(m_tokens.size())
+		if(m_entries.size())
+		{
+			++m_numChanges;
+		}
+		for(const Entry& entry : m_entries)
 		{
-			m_tokens.erase(std::remove_if(m_tokens.begin(), m_tokens.end(), [](const std::weak_ptr<Token>& in_token) {
-				return in_token.expired();
-			}), m_tokens.end());
+			entry.token->RemoveLink(this);
 		}
+		m_entries.clear();
+		m_oldestIdx = SIZE_MAX;
+		m_newestIdx = SIZE_MAX;
+		std::vector<TimedTokenQueue> timedTokenQueues = std::move(m_timedTokenQueues);
+		m_timedTokenQueues.clear(); // (Timed tokens are released only after the list is in a consistent state)
 	}
-	template <typename tFn>
-	void SanitizeAndProcessData(tFn in_dataFn) const
+	void MoveEntriesFrom(TokenListBase& io_other) // Takes over another list's entries (which must leave this list empty)
 	{
-		// Remove all invalid tokens while applying a processing function on each valid token
-		if(m_tokens.size())
+		if(io_other.m_entries.size()) // (Waiters stay with their own list)
 		{
-			m_tokens.erase(std::remove_if(m_tokens.begin(), m_tokens.end(), [&in_dataFn](const std::weak_ptr<Token>& in_token) {
-				if(in_token.expired())
-				{
-					return true;
-				}
-				if(auto token = in_token.lock())
-				{
-					in_dataFn(token->data);
-				}
-				return false;
-			}), m_tokens.end());
+			++m_numChanges;
+			++io_other.m_numChanges;
+		}
+		m_entries = std::move(io_other.m_entries);
+		m_oldestIdx = io_other.m_oldestIdx;
+		m_newestIdx = io_other.m_newestIdx;
+		m_timedTokenQueues = std::move(io_other.m_timedTokenQueues);
+		io_other.m_entries.clear();
+		io_other.m_oldestIdx = SIZE_MAX;
+		io_other.m_newestIdx = SIZE_MAX;
+		io_other.m_timedTokenQueues.clear();
+		for(const Entry& entry : m_entries)
+		{
+			entry.token->FindLink(&io_other)->list = this;
 		}
 	}
 
-	// Token data
-	mutable std::vector<std::weak_ptr<Token>> m_tokens; // Mutable so we can remove expired tokens while converting bool
-};
+	virtual void OnRemoveEntry(size_t, size_t) // Called before an entry is removed (and the last entry is moved into its slot)
+	{
+	}
+	virtual void OnRemoveEntryData(size_t) // Called before an entry's data is changed
+	{
+	}
+	virtual void OnAddEntryData(size_t) // Called after an entry's data is changed
+	{
+	}
+	template <typename tSetDataFn>
+	static void SetTokenData(TokenBase* in_token, tSetDataFn in_setDataFn) // Changes a token's data, updating the aggregates of every list it belongs to
+	{
+		auto forEachLink = [in_token](auto in_fn) {
+			if(in_token->m_link.list)
+			{
+				in_fn(in_token->m_link);
+			}
+			for(const TokenLink& link : in_token->m_extraLinks)
+			{
+				in_fn(link);
+			}
+		};
+		forEachLink([](const TokenLink& in_link) { in_link.list->OnRemoveEntryData(in_link.idx); });
+		in_setDataFn();
+		forEachLink([](const TokenLink& in_link) { in_link.list->OnAddEntryData(in_link.idx); });
+	}
+
+	std::vector<Entry> m_entries; // Live tokens (in no particular order)
+	size_t m_oldestIdx = SIZE_MAX; // Least-recently-added entry
+	size_t m_newestIdx = SIZE_MAX; // Most-recently-added entry
+	uint64_t m_numChanges = 0; // Number of times a token has been added or removed
+	std::vector<Waiter*> m_waiters; // Tasks waiting on the list
+	std::vector<TimedTokenQueue> m_timedTokenQueues; // Timed tokens held by the list (one queue per time-stream)
+
+private:
+	friend class TokenBase;
+	void RemoveEntryAt(size_t in_idx)
+	{
+		size_t lastIdx = m_entries.size() - 1;
+		OnRemoveEntry(in_idx, lastIdx);
+
+		// Unthread the entry from the recency list
+		Entry& entry = m_entries[in_idx];
+		(entry.prevIdx != SIZE_MAX ? m_entries[entry.prevIdx].nextIdx : m_oldestIdx) = entry.nextIdx;
+		(entry.nextIdx != SIZE_MAX ? m_entries[entry.nextIdx].prevIdx : m_newestIdx) = entry.prevIdx;
+
+		// Swap-remove the entry (moving the last entry into its slot)
+		if(in_idx != lastIdx)
+		{
+			Entry& movedEntry = m_entries[in_idx];
+			movedEntry = m_entries[lastIdx];
+			(movedEntry.prevIdx != SIZE_MAX ? m_entries[movedEntry.prevIdx].nextIdx : m_oldestIdx) = in_idx;
+			(movedEntry.nextIdx != SIZE_MAX ? m_entries[movedEntry.nextIdx].prevIdx : m_newestIdx) = in_idx;
+			movedEntry.token->FindLink(this)->idx = in_idx;
+		}
+		m_entries.pop_back();
+		++m_numChanges;
+	}
+};
+
+inline void TokenBase::RemoveFromLists()
+{
+	while(m_link.list)
+	{
+		TokenListBase* list = m_link.list;
+		size_t idx = m_link.idx;
+		RemoveLink(list);
+		list->RemoveEntryAt(idx);
+	}
+}
+
+/// @private Aggregate over the data of a token list's entries, maintained incrementally as tokens are added and removed
+template <typename T>
+class TokenAggregator
+{
+public:
+	virtual ~TokenAggregator() = default;
+	virtual void Add(size_t in_entryIdx, const T& in_data) = 0;
+	virtual void Remove(size_t in_entryIdx, const T& in_data) = 0;
+	virtual void Move(size_t in_fromIdx, size_t in_toIdx) = 0; // Called when an entry is moved to another slot
+	virtual void Clear() = 0;
+};
+
+/// @private Heap of entry data, ordered so that the first element according to tCompare is on top (O(log n) add/remove)
+template <typename T, typename tCompare>
+class TokenHeapAggregator : public TokenAggregator<T>
+{
+public:
+	const T& GetTop() const
+	{
+		return m_nodes[0].data;
+	}
+	virtual void Add(size_t in_entryIdx, const T& in_data) override
+	{
+		if(in_entryIdx >= m_nodePositions.size())
+		{
+			m_nodePositions.resize(in_entryIdx + 1);
+		}
+		m_nodes.push_back({ in_data, in_entryIdx });
+		m_nodePositions[in_entryIdx] = m_nodes.size() - 1;
+		SiftUp(m_nodes.size() - 1);
+	}
+	virtual void Remove(size_t in_entryIdx, const T&) override
+	{
+		size_t pos = m_nodePositions[in_entryIdx];
+		size_t lastPos = m_nodes.size() - 1;
+		if(pos != lastPos)
+		{
+			SetNode(pos, std::move(m_nodes[lastPos]));
+			m_nodes.pop_back();
+			SiftDown(SiftUp(pos));
+		}
+		else
+		{
+			m_nodes.pop_back();
+		}
+	}
+	virtual void Move(size_t in_fromIdx, size_t in_toIdx) override
+	{
+		size_t pos = m_nodePositions[in_fromIdx];
+		m_nodes[pos].entryIdx = in_toIdx;
+		m_nodePositions[in_toIdx] = pos;
+	}
+	virtual void Clear() override
+	{
+		m_nodes.clear();
+		m_nodePositions.clear();
+	}
+
+private:
+	struct Node
+	{
+		T data; // (Copied into the heap, so that sifting does not need to visit each token)
+		size_t entryIdx;
+	};
+
+	void SetNode(size_t in_pos, Node&& in_node)
+	{
+		m_nodePositions[in_node.entryIdx] = in_pos;
+		m_nodes[in_pos] = std::move(in_node);
+	}
+	size_t SiftUp(size_t in_pos)
+	{
+		while(in_pos > 0)
+		{
+			size_t parentPos = (in_pos - 1) / 2;
+			if(!tCompare{}(m_nodes[in_pos].data, m_nodes[parentPos].data))
+			{
+				break;
+			}
+			Node node = std::move(m_nodes[in_pos]);
+			SetNode(in_pos, std::move(m_nodes[parentPos]));
+			SetNode(parentPos, std::move(node));
+			in_pos = parentPos;
+		}
+		return in_pos;
+	}
+	void SiftDown(size_t in_pos)
+	{
+		while(true)
+		{
+			size_t bestPos = in_pos;
+			for(size_t childPos = in_pos * 2 + 1; childPos <= in_pos * 2 + 2 && childPos < m_nodes.size(); ++childPos)
+			{
+				if(tCompare{}(m_nodes[childPos].data, m_nodes[bestPos].data))
+				{
+					bestPos = childPos;
+				}
+			}
+			if(bestPos == in_pos)
+			{
+				return;
+			}
+			Node node = std::move(m_nodes[in_pos]);
+			SetNode(in_pos, std::move(m_nodes[bestPos]));
+			SetNode(bestPos, std::move(node));
+			in_pos = bestPos;
+		}
+	}
+
+	std::vector<Node> m_nodes;
+	std::vector<size_t> m_nodePositions; // Position of each entry's node in the heap (indexed by entry)
+};
+
+/// @private Running sum of entry data (O(1) add/remove)
+template <typename T>
+class TokenSumAggregator : public TokenAggregator<T>
+{
+public:
+	double GetSum() const
+	{
+		return m_sum;
+	}
+	virtual void Add(size_t, const T& in_data) override
+	{
+		m_sum += (double)in_data;
+		++m_count;
+	}
+	virtual void Remove(size_t, const T& in_data) override
+	{
+		m_sum = (--m_count > 0) ? m_sum - (double)in_data : 0.0; // Reset when empty, so rounding error cannot accumulate indefinitely
+	}
+	virtual void Move(size_t, size_t) override
+	{
+	}
+	virtual void Clear() override
+	{
+		m_sum = 0.0;
+		m_count = 0;
+	}
+
+private:
+	double m_sum = 0.0;
+	size_t m_count = 0;
+};
+
+/// @private Hash multiset of entry data (O(1) add/remove/contains)
+template <typename T>
+class TokenMultisetAggregator : public TokenAggregator<T>
+{
+public:
+	bool Contains(const T& in_data) const
+	{
+		return m_counts.find(in_data) != m_counts.end();
+	}
+	virtual void Add(size_t, const T& in_data) override
+	{
+		++m_counts[in_data];
+	}
+	virtual void Remove(size_t, const T& in_data) override
+	{
+		auto foundIter = m_counts.find(in_data);
+		if(foundIter != m_counts.end() && --foundIter->second == 0)
+		{
+			m_counts.erase(foundIter);
+		}
+	}
+	virtual void Move(size_t, size_t) override
+	{
+	}
+	virtual void Clear() override
+	{
+		m_counts.clear();
+	}
+
+private:
+	std::unordered_map<T, size_t> m_counts;
+};
+
+/// @private Segment tree that combines entry data with a user-defined monoid (O(log n) add/remove, O(1) query)
+template <typename T>
+class TokenMonoidAggregator : public TokenAggregator<T>
+{
+public:
+	TokenMonoidAggregator(T in_identity, std::function<T(const T&, const T&)> in_combineFn)
+		: m_identity(std::move(in_identity))
+		, m_combineFn(std::move(in_combineFn))
+	{
+	}
+	const T& GetIdentity() const
+	{
+		return m_identity;
+	}
+	const std::function<T(const T&, const T&)>& GetCombineFn() const
+	{
+		return m_combineFn;
+	}
+	const T& GetResult() const
+	{
+		return m_tree.size() ? m_tree[1] : m_identity;
+	}
+	virtual void Add(size_t in_entryIdx, const T& in_data) override
+	{
+		if(in_entryIdx >= m_numLeaves)
+		{
+			Grow(in_entryIdx + 1);
+		}
+		SetLeaf(in_entryIdx, in_data);
+	}
+	virtual void Remove(size_t in_entryIdx, const T&) override
+	{
+		SetLeaf(in_entryIdx, m_identity);
+	}
+	virtual void Move(size_t in_fromIdx, size_t in_toIdx) override
+	{
+		SetLeaf(in_toIdx, m_tree[m_numLeaves + in_fromIdx]);
+		SetLeaf(in_fromIdx, m_identity);
+	}
+	virtual void Clear() override
+	{
+		m_tree.clear();
+		m_numLeaves = 0;
+	}
+
+private:
+	void Grow(size_t in_minLeaves)
+	{
+		// Double the number of leaves (re-combining every node above them)
+		size_t numLeaves = std::max(m_numLeaves, (size_t)8);
+		while(numLeaves < in_minLeaves)
+		{
+			numLeaves *= 2;
+		}
+		std::vector<T> tree(numLeaves * 2, m_identity);
+		std::move(m_tree.begin() + m_numLeaves, m_tree.end(), tree.begin() + numLeaves);
+		for(size_t nodeIdx = numLeaves - 1; nodeIdx > 0; --nodeIdx)
+		{
+			tree[nodeIdx] = m_combineFn(tree[nodeIdx * 2], tree[nodeIdx * 2 + 1]);
+		}
+		m_tree = std::move(tree);
+		m_numLeaves = numLeaves;
+	}
+	void SetLeaf(size_t in_leafIdx, const T& in_data)
+	{
+		size_t nodeIdx = m_numLeaves + in_leafIdx;
+		m_tree[nodeIdx] = in_data;
+		for(nodeIdx /= 2; nodeIdx > 0; nodeIdx /= 2)
+		{
+			m_tree[nodeIdx] = m_combineFn(m_tree[nodeIdx * 2], m_tree[nodeIdx * 2 + 1]);
+		}
+	}
+
+	T m_identity;
+	std::function<T(const T&, const T&)> m_combineFn;
+	std::vector<T> m_tree; // Nodes of the tree (the root is at index 1, and leaves are indexed by entry from m_numLeaves)
+	size_t m_numLeaves = 0;
+};
+
+/// @private Whether std::hash is enabled for a type
+template <typename T, typename = void>
+struct IsTokenDataHashable : std::false_type
+{
+};
+template <typename T>
+struct IsTokenDataHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type
+{
+};
+
+/// @brief Container for tracking decentralized state across multiple tasks. (See \ref Tokens for more info...)
+/// @tparam T Type of data to associate with each Token in this container
+template <typename T>
+class TokenList : public TokenListBase
+{
+public:
+	/// Type of Token tracked by this container
+	using Token = typename std::conditional_t<std::is_void<T>::value, NAMESPACE_SQUID::Token, DataToken<T>>;
+
+	/// Type of data aggregated by the container's data queries (only used by containers whose tokens have data)
+	using tAggregateData = std::conditional_t<std::is_void<T>::value, char, T>;
+
+	TokenList() = default; /// Default constructor
+	TokenList(const TokenList& in_other) /// Copy constructor (adds each of the other list's live tokens, from least- to most-recently-added)
+	{
+		CopyFrom(in_other);
+	}
+	TokenList(TokenList&& in_other) noexcept /// Move constructor
+	{
+		MoveFrom(in_other);
+	}
+	TokenList& operator=(const TokenList& in_other) /// Copy assignment operator
+	{
+		if(this != &in_other)
+		{
+			RemoveAllEntries();
+			CopyFrom(in_other);
+		}
+		return *this;
+	}
+	TokenList& operator=(TokenList&& in_other) noexcept /// Move assignment operator
+	{
+		if(this != &in_other)
+		{
+			RemoveAllEntries();
+			MoveFrom(in_other);
+		}
+		return *this;
+	}
+
+	/// Create a token with the specified debug name
+	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
+	static std::shared_ptr<Token> MakeToken(TokenName in_name)
+	{
+		return MakeSharedToken<Token>(in_name);
+	}
+
+	/// Create a token with the specified debug name and associated data
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	static std::shared_ptr<Token> MakeToken(TokenName in_name, U in_data)
+	{
+		return MakeSharedToken<Token>(in_name, std::move(in_data));
+	}
+
+	/// Create and add a token with the specified debug name
+	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
+	SQUID_NODISCARD std::shared_ptr<Token> TakeToken(TokenName in_name)
+	{
+		return AddTokenInternal(MakeToken(in_name));
+	}
+
+	/// Create and add a token with the specified debug name and associated data
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	SQUID_NODISCARD std::shared_ptr<Token> TakeToken(TokenName in_name, U in_data)
+	{
+		return AddTokenInternal(MakeToken(in_name, std::move(in_data)));
+	}
+
+	/// @brief Create and add a token with the specified debug name, which the container holds until a duration has
+	/// elapsed in a time-stream
+	/// @details Timed tokens need no task to hold them. Each container keeps its timed tokens in a queue ordered by
+	/// deadline, and removes every expired token in one batch whenever it is next queried (or polled by a waiting task).
+	/// The returned token can be used to remove the token early (via RemoveToken()), or to add it to other containers.
+	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
+	std::shared_ptr<Token> TakeTokenFor(TokenName in_name, tTaskTime in_duration, const TimeStream& in_timeStream)
+	{
+		auto token = AddTokenInternal(MakeToken(in_name));
+		AddTimedToken(token, in_duration, in_timeStream);
+		return token;
+	}
+
+	/// @brief Create and add a token with the specified debug name and associated data, which the container holds until
+	/// a duration has elapsed in a time-stream
+	/// @details See the overload above for details.
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	std::shared_ptr<Token> TakeTokenFor(TokenName in_name, U in_data, tTaskTime in_duration, const TimeStream& in_timeStream)
+	{
+		auto token = AddTokenInternal(MakeToken(in_name, std::move(in_data)));
+		AddTimedToken(token, in_duration, in_timeStream);
+		return token;
+	}
+#if SQUID_TIME_TICKS
+	template <typename tSeconds, tIfFloatSeconds<tSeconds> = 0>
+	std::shared_ptr<Token> TakeTokenFor(TokenName in_name, tSeconds in_duration, const TimeStream& in_timeStream) /// @private Illegal floating-point implementation
+	{
+		static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+		return nullptr;
+	}
+	template <typename U = T, typename tSeconds, tIfFloatSeconds<tSeconds> = 0>
+	std::shared_ptr<Token> TakeTokenFor(TokenName in_name, U in_data, tSeconds in_duration, const TimeStream& in_timeStream) /// @private Illegal floating-point implementation
+	{
+		static_assert(static_false<tSeconds>::value, SQUID_FLOAT_SECONDS_ERROR);
+		return nullptr;
+	}
+#endif //SQUID_TIME_TICKS
+
+	/// Add an existing token to this container (tokens that have already been added are not added again)
+	std::shared_ptr<Token> AddToken(std::shared_ptr<Token> in_token)
+	{
+		SQUID_RUNTIME_CHECK(in_token, "Cannot add null token");
+		if(!ContainsEntry(in_token.get())) // Prevent duplicate tokens
+		{
+			return AddTokenInternal(in_token);
+		}
+		return in_token;
+	}
+
+	/// Explicitly remove a token from this container
+	void RemoveToken(std::shared_ptr<Token> in_token)
+	{
+		if(in_token)
+		{
+			RemoveEntry(in_token.get());
+		}
+	}
+
+	/// @brief Set the data associated with a token
+	/// @details Token data is otherwise read-only, because containers aggregate it (e.g. for GetMax()). Setting it here
+	/// updates the aggregates of every container the token belongs to (not just this one).
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	void SetData(const std::shared_ptr<Token>& in_token, U in_data)
+	{
+		SQUID_RUNTIME_CHECK(in_token, "Cannot set the data of a null token");
+		SetTokenData(in_token.get(), [&in_token, &in_data] { in_token->m_data = std::move(in_data); });
+	}
+
+	/// Convenience conversion operator that calls HasTokens()
+	operator bool() const
+	{
+		return HasTokens();
+	}
+
+	/// Returns whether this container holds any live tokens
+	bool HasTokens() const
+	{
+		ExpireTimedTokens();
+		return !m_entries.empty(); // Tokens remove themselves from the container when destroyed
+	}
+
+	/// Returns the number of live tokens
+	size_t GetNumTokens() const
+	{
+		ExpireTimedTokens();
+		return m_entries.size();
+	}
+
+	/// @brief Zero-copy view over the associated data of all live tokens (in no particular order)
+	/// @details The view (and its iterators) are invalidated when a token is added to or removed from the container.
+	class TokenDataView
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			Iterator(const Entry* in_entry)
+				: m_entry(in_entry)
+			{
+			}
+			const T& operator*() const
+			{
+				return static_cast<const Token*>(m_entry->token)->GetData();
+			}
+			const T* operator->() const
+			{
+				return &**this;
+			}
+			Iterator& operator++()
+			{
+				++m_entry;
+				return *this;
+			}
+			Iterator operator++(int)
+			{
+				Iterator prevIter = *this;
+				++m_entry;
+				return prevIter;
+			}
+			bool operator==(const Iterator& in_other) const
+			{
+				return m_entry == in_other.m_entry;
+			}
+			bool operator!=(const Iterator& in_other) const
+			{
+				return m_entry != in_other.m_entry;
+			}
+
+		private:
+			const Entry* m_entry;
+		};
+
+		TokenDataView(const std::vector<Entry>& in_entries)
+			: m_entries(in_entries)
+		{
+		}
+		Iterator begin() const
+		{
+			return Iterator(m_entries.data());
+		}
+		Iterator end() const
+		{
+			return Iterator(m_entries.data() + m_entries.size());
+		}
+		size_t size() const
+		{
+			return m_entries.size();
+		}
+		bool empty() const
+		{
+			return m_entries.empty();
+		}
+
+	private:
+		const std::vector<Entry>& m_entries;
+	};
+
+	/// Returns a zero-copy view over the associated data of all live tokens (in no particular order)
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	TokenDataView GetTokenDataView() const
+	{
+		ExpireTimedTokens();
+		return TokenDataView(m_entries);
+	}
+
+	/// Returns an array of all live token data (see GetTokenDataView() to iterate over the data without copying it)
+	std::vector<T> GetTokenData() const
+	{
+		ExpireTimedTokens();
+		TokenDataView dataView(m_entries);
+		return std::vector<T>(dataView.begin(), dataView.end());
+	}
+
+	/// @name Data Queries
+	/// Methods for querying and aggregating the data from the set of live tokens.
+	/// 
+	/// Aggregates (min, max, sum/mean and the set of data searched by Contains()) are built the first time they are
+	/// queried, and are then maintained incrementally as tokens are added, removed and expire. Subsequent queries are O(1),
+	/// and each aggregate that has been queried adds O(log n) (min/max) or O(1) (sum/mean/contains) to the cost of adding
+	/// or removing a token. Contains() falls back to a linear search for data types without a std::hash specialization.
+	/// @{
+	
+	/// Returns associated data from the least-recently-added live token
+	std::optional<T> GetLeastRecent() const
+	{
+		ExpireTimedTokens();
+		return m_entries.size() ? GetData(m_oldestIdx) : std::optional<T>{};
+	}
+
+	/// Returns associated data from the most-recently-added live token
+	std::optional<T> GetMostRecent() const
+	{
+		ExpireTimedTokens();
+		return m_entries.size() ? GetData(m_newestIdx) : std::optional<T>{};
+	}
+
+	/// Returns smallest associated data from the set of live tokens
+	std::optional<T> GetMin() const
+	{
+		ExpireTimedTokens();
+		if(!m_minAggregator)
+		{
+			m_minAggregator = MakeAggregator<TokenHeapAggregator<T, std::less<T>>>();
+		}
+		return m_entries.size() ? m_minAggregator->GetTop() : std::optional<T>{};
+	}
+
+	/// Returns largest associated data from the set of live tokens
+	std::optional<T> GetMax() const
+	{
+		ExpireTimedTokens();
+		if(!m_maxAggregator)
+		{
+			m_maxAggregator = MakeAggregator<TokenHeapAggregator<T, std::greater<T>>>();
+		}
+		return m_entries.size() ? m_maxAggregator->GetTop() : std::optional<T>{};
+	}
+
+	/// Returns the sum of all associated data from the set of live tokens (0 if there are no live tokens)
+	double GetSum() const
+	{
+		ExpireTimedTokens();
+		if(!m_sumAggregator)
+		{
+			m_sumAggregator = MakeAggregator<TokenSumAggregator<T>>();
+		}
+		return m_sumAggregator->GetSum();
+	}
+
+	/// Returns arithmetic mean of all associated data from the set of live tokens
+	std::optional<double> GetMean() const
+	{
+		double sum = GetSum();
+		return m_entries.size() ? sum / m_entries.size() : std::optional<double>{};
+	}
+
+	/// Returns whether the set of live tokens contains at least one token associated with the specified data
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	bool Contains(const U& in_searchData) const
+	{
+		ExpireTimedTokens();
+		if constexpr(IsTokenDataHashable<U>::value)
+		{
+			if(!m_multisetAggregator)
+			{
+				m_multisetAggregator = MakeAggregator<TokenMultisetAggregator<T>>();
+			}
+			return m_multisetAggregator->Contains(in_searchData);
+		}
+		else
+		{
+			TokenDataView dataView(m_entries);
+			return std::find(dataView.begin(), dataView.end(), in_searchData) != dataView.end();
+		}
+	}
+
+	/// @brief Sets a user-defined aggregate over the data of all live tokens, queried with GetAggregate()
+	/// @details The combine function and identity must form a commutative monoid (e.g. 1 and multiplication, to find
+	/// the product of a set of speed multipliers). The aggregate is maintained incrementally, with an O(log n) cost per
+	/// token added or removed, and GetAggregate() is O(1). Replaces any previously-set aggregate.
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	void SetAggregateFn(tAggregateData in_identity, std::function<tAggregateData(const tAggregateData&, const tAggregateData&)> in_combineFn)
+	{
+		RemoveAggregator(m_monoidAggregator);
+		m_monoidAggregator = MakeAggregator<TokenMonoidAggregator<T>>(std::move(in_identity), std::move(in_combineFn));
+	}
+
+	/// Returns the user-defined aggregate (see SetAggregateFn()) of all live token data (its identity if there are no live tokens)
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	U GetAggregate() const
+	{
+		SQUID_RUNTIME_CHECK(m_monoidAggregator, "Cannot get aggregate before calling SetAggregateFn()");
+		ExpireTimedTokens();
+		return m_monoidAggregator->GetResult();
+	}
+	///@} end of Data Queries
+
+	/// Returns a debug string containing a list of the debug names of all live tokens (from least- to most-recently-added)
+	std::string GetDebugString() const 
+	{
+		ExpireTimedTokens();
+		std::string debugStr;
+		for(size_t idx = m_oldestIdx; idx != SIZE_MAX; idx = m_entries[idx].nextIdx)
+		{
+			if(debugStr.size() > 0)
+			{
+				debugStr += "\n";
+			}
+			debugStr += m_entries[idx].token->name.GetString();
+		}
+		if(debugStr.size() == 0)
+		{
+			debugStr = "[no tokens]";
+		}
+		return debugStr;
+	}
+
+private:
+	// Shared internal implementation for adding tokens
+	std::shared_ptr<Token> AddTokenInternal(std::shared_ptr<Token> in_token)
+	{
+		AddEntry(in_token.get());
+		if constexpr(!std::is_void<T>::value)
+		{
+			size_t idx = m_entries.size() - 1;
+			for(const auto& aggregator : m_aggregators)
+			{
+				aggregator->Add(idx, GetData(idx));
+			}
+		}
+		return in_token;
+	}
+	virtual void OnRemoveEntry(size_t in_idx, size_t in_lastIdx) override
+	{
+		if constexpr(!std::is_void<T>::value)
+		{
+			for(const auto& aggregator : m_aggregators)
+			{
+				aggregator->Remove(in_idx, GetData(in_idx));
+				if(in_idx != in_lastIdx)
+				{
+					aggregator->Move(in_lastIdx, in_idx);
+				}
+			}
+		}
+	}
+	virtual void OnRemoveEntryData(size_t in_idx) override
+	{
+		if constexpr(!std::is_void<T>::value)
+		{
+			for(const auto& aggregator : m_aggregators)
+			{
+				aggregator->Remove(in_idx, GetData(in_idx));
+			}
+		}
+	}
+	virtual void OnAddEntryData(size_t in_idx) override
+	{
+		if constexpr(!std::is_void<T>::value)
+		{
+			for(const auto& aggregator : m_aggregators)
+			{
+				aggregator->Add(in_idx, GetData(in_idx));
+			}
+		}
+	}
+
+	// Copying and moving (queried aggregates are moved along with the tokens, but are rebuilt on demand after copies)
+	void CopyFrom(const TokenList& in_other)
+	{
+		ResetAggregators();
+		for(size_t idx = in_other.m_oldestIdx; idx != SIZE_MAX; idx = in_other.m_entries[idx].nextIdx)
+		{
+			AddEntry(in_other.m_entries[idx].token);
+		}
+		if constexpr(!std::is_void<T>::value)
+		{
+			if(in_other.m_monoidAggregator)
+			{
+				SetAggregateFn(in_other.m_monoidAggregator->GetIdentity(), in_other.m_monoidAggregator->GetCombineFn());
+			}
+		}
+	}
+	void MoveFrom(TokenList& io_other)
+	{
+		MoveEntriesFrom(io_other);
+		m_aggregators = std::move(io_other.m_aggregators);
+		m_minAggregator = io_other.m_minAggregator;
+		m_maxAggregator = io_other.m_maxAggregator;
+		m_sumAggregator = io_other.m_sumAggregator;
+		m_multisetAggregator = io_other.m_multisetAggregator;
+		m_monoidAggregator = io_other.m_monoidAggregator;
+		io_other.ResetAggregators();
+	}
+
+	// Aggregates
+	template <typename tAggregator, typename... tArgs>
+	tAggregator* MakeAggregator(tArgs&&... in_args) const
+	{
+		auto aggregator = std::make_unique<tAggregator>(std::forward<tArgs>(in_args)...);
+		for(size_t idx = 0; idx < m_entries.size(); ++idx)
+		{
+			aggregator->Add(idx, GetData(idx));
+		}
+		m_aggregators.push_back(std::move(aggregator));
+		return static_cast<tAggregator*>(m_aggregators.back().get());
+	}
+	void RemoveAggregator(TokenAggregator<tAggregateData>* in_aggregator)
+	{
+		m_aggregators.erase(std::remove_if(m_aggregators.begin(), m_aggregators.end(), [in_aggregator](const auto& in_ptr) {
+			return in_ptr.get() == in_aggregator;
+		}), m_aggregators.end());
+	}
+	void ResetAggregators()
+	{
+		m_aggregators.clear();
+		m_minAggregator = nullptr;
+		m_maxAggregator = nullptr;
+		m_sumAggregator = nullptr;
+		m_multisetAggregator = nullptr;
+		m_monoidAggregator = nullptr;
+	}
+	template <typename U = T>
+	const U& GetData(size_t in_idx) const
+	{
+		return static_cast<const Token*>(m_entries[in_idx].token)->GetData();
+	}
+
+	mutable std::vector<std::unique_ptr<TokenAggregator<tAggregateData>>> m_aggregators; // Aggregates that have been queried (updated as tokens are added and removed)
+	mutable TokenHeapAggregator<tAggregateData, std::less<tAggregateData>>* m_minAggregator = nullptr;
+	mutable TokenHeapAggregator<tAggregateData, std::greater<tAggregateData>>* m_maxAggregator = nullptr;
+	mutable TokenSumAggregator<tAggregateData>* m_sumAggregator = nullptr;
+	mutable TokenMultisetAggregator<tAggregateData>* m_multisetAggregator = nullptr;
+	TokenMonoidAggregator<tAggregateData>* m_monoidAggregator = nullptr;
+};
+
+class TokenCounter;
+
+/// @brief Movable scope guard that holds one token in a TokenCounter (the token is released when the guard is destroyed)
+class CountedToken
+{
+public:
+	CountedToken() = default; /// Default constructor (holds no token)
+	CountedToken(CountedToken&& in_other) noexcept /// Move constructor
+	{
+		MoveFrom(in_other);
+	}
+	CountedToken& operator=(CountedToken&& in_other) noexcept /// Move assignment operator
+	{
+		if(this != &in_other)
+		{
+			Release();
+			MoveFrom(in_other);
+		}
+		return *this;
+	}
+	~CountedToken() /// Destructor (releases the token)
+	{
+		Release();
+	}
+	CountedToken(const CountedToken&) = delete;
+	CountedToken& operator=(const CountedToken&) = delete;
+
+	/// Returns whether this guard holds a token
+	bool IsHeld() const
+	{
+		return m_counter != nullptr;
+	}
+
+	/// Releases the token early (if it is held)
+	void Release();
+
+private:
+	friend class TokenCounter;
+	CountedToken(TokenCounter* in_counter, TokenName in_name);
+	void MoveFrom(CountedToken& io_other);
+
+	TokenCounter* m_counter = nullptr;
+#if SQUID_ENABLE_TOKEN_NAMES
+	TokenName m_name; // Used for debug only
+	CountedToken* m_prevToken = nullptr; // Previous (less-recently-taken) token in the counter
+	CountedToken* m_nextToken = nullptr; // Next (more-recently-taken) token in the counter
+#endif //SQUID_ENABLE_TOKEN_NAMES
+};
+
+/// @brief Compact alternative to TokenList<> that only counts its live tokens
+/// @details Tokens are @ref CountedToken scope guards rather than shared pointers, so taking and releasing a token is an
+/// increment and a decrement, and HasTokens() is a single integer compare. Taking a token never allocates. When
+/// SQUID_ENABLE_TOKEN_NAMES is set, each guard also records its debug name (see @ref TokenName), and the counter links
+/// its live guards together for GetDebugString().
+/// 
+/// Unlike a TokenList<>, a counter cannot be copied or moved, and its tokens cannot be shared with other containers.
+/// Every token must be released before its counter is destroyed.
+class TokenCounter
+{
+public:
+	TokenCounter() = default; /// Default constructor
+	~TokenCounter() /// Destructor
+	{
+		SQUID_NOTHROW_CHECK(m_numTokens == 0, "TokenCounter destroyed while tokens are still held");
+	}
+	TokenCounter(const TokenCounter&) = delete; // Guards refer to the counter by address
+	TokenCounter& operator=(const TokenCounter&) = delete;
+
+	/// Take a token with the specified debug name (held until the returned guard is destroyed or released)
+	SQUID_NODISCARD CountedToken TakeToken(TokenName in_name)
+	{
+		return CountedToken(this, in_name);
+	}
+
+	/// Convenience conversion operator that calls HasTokens()
+	operator bool() const
+	{
+		return HasTokens();
+	}
+
+	/// Returns whether any tokens are held
+	bool HasTokens() const
+	{
+		return m_numTokens != 0;
+	}
+
+	/// Returns the number of tokens held
+	uint32_t GetNumTokens() const
+	{
+		return m_numTokens;
+	}
+
+	/// Returns a debug string containing a list of the debug names of all held tokens (from least- to most-recently-taken)
+	std::string GetDebugString() const
+	{
+#if SQUID_ENABLE_TOKEN_NAMES
+		std::string debugStr;
+		for(const CountedToken* token = m_oldestToken; token; token = token->m_nextToken)
+		{
+			if(debugStr.size() > 0)
+			{
+				debugStr += "\n";
+			}
+			debugStr += token->m_name.GetString();
+		}
+		return debugStr.size() ? debugStr : "[no tokens]";
+#else
+		return m_numTokens ? "[" + std::to_string(m_numTokens) + " token(s)]" : "[no tokens]";
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	}
+
+private:
+	friend class CountedToken;
+
+	uint32_t m_numTokens = 0;
+#if SQUID_ENABLE_TOKEN_NAMES
+	CountedToken* m_oldestToken = nullptr;
+	CountedToken* m_newestToken = nullptr;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+};
+
+inline CountedToken::CountedToken(TokenCounter* in_counter, TokenName in_name)
+	: m_counter(in_counter)
+{
+	++m_counter->m_numTokens;
+#if SQUID_ENABLE_TOKEN_NAMES
+	m_name = in_name;
+	m_prevToken = m_counter->m_newestToken;
+	(m_prevToken ? m_prevToken->m_nextToken : m_counter->m_oldestToken) = this;
+	m_counter->m_newestToken = this;
+#else
+	(void)in_name;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+}
+inline void CountedToken::Release()
+{
+	if(!m_counter)
+	{
+		return;
+	}
+	--m_counter->m_numTokens;
+#if SQUID_ENABLE_TOKEN_NAMES
+	(m_prevToken ? m_prevToken->m_nextToken : m_counter->m_oldestToken) = m_nextToken;
+	(m_nextToken ? m_nextToken->m_prevToken : m_counter->m_newestToken) = m_prevToken;
+	m_prevToken = nullptr;
+	m_nextToken = nullptr;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	m_counter = nullptr;
+}
+inline void CountedToken::MoveFrom(CountedToken& io_other)
+{
+	m_counter = io_other.m_counter;
+	io_other.m_counter = nullptr;
+#if SQUID_ENABLE_TOKEN_NAMES
+	m_name = io_other.m_name;
+	m_prevToken = io_other.m_prevToken;
+	m_nextToken = io_other.m_nextToken;
+	io_other.m_prevToken = nullptr;
+	io_other.m_nextToken = nullptr;
+	if(m_counter) // Take over the other guard's place in the counter's list
+	{
+		(m_prevToken ? m_prevToken->m_nextToken : m_counter->m_oldestToken) = this;
+		(m_nextToken ? m_nextToken->m_prevToken : m_counter->m_newestToken) = this;
+	}
+#endif //SQUID_ENABLE_TOKEN_NAMES
+}
+
+//--- TokenRegistry ---//
+/// Identifier of a token list within a @ref TokenRegistry
+using tTokenListId = uint32_t;
+
+template <typename T>
+class TokenRegistry;
+
+/// @brief Movable scope guard that holds one token in a TokenRegistry list (the token is released when the guard is destroyed)
+template <typename T>
+class RegistryToken
+{
+public:
+	RegistryToken() = default; /// Default constructor (holds no token)
+	RegistryToken(RegistryToken&& in_other) noexcept /// Move constructor
+		: m_registry(in_other.m_registry)
+		, m_slot(in_other.m_slot)
+	{
+		in_other.m_registry = nullptr;
+	}
+	RegistryToken& operator=(RegistryToken&& in_other) noexcept /// Move assignment operator
+	{
+		if(this != &in_other)
+		{
+			Release();
+			m_registry = in_other.m_registry;
+			m_slot = in_other.m_slot;
+			in_other.m_registry = nullptr;
+		}
+		return *this;
+	}
+	~RegistryToken() /// Destructor (releases the token)
+	{
+		Release();
+	}
+	RegistryToken(const RegistryToken&) = delete;
+	RegistryToken& operator=(const RegistryToken&) = delete;
+
+	/// Returns whether this guard holds a token
+	bool IsHeld() const
+	{
+		return m_registry != nullptr;
+	}
+
+	/// Returns the data associated with the held token
+	T GetData() const
+	{
+		SQUID_RUNTIME_CHECK(m_registry, "Cannot get the data of a released registry token");
+		return m_registry->m_values[m_registry->m_slotIdxs[m_slot]];
+	}
+
+	/// Sets the data associated with the held token (in place, without releasing the token)
+	void SetData(T in_data)
+	{
+		SQUID_RUNTIME_CHECK(m_registry, "Cannot set the data of a released registry token");
+		m_registry->m_values[m_registry->m_slotIdxs[m_slot]] = in_data;
+	}
+
+	/// Releases the token early (if it is held)
+	void Release()
+	{
+		if(m_registry)
+		{
+			m_registry->RemoveToken(m_slot);
+			m_registry = nullptr;
+		}
+	}
+
+private:
+	friend class TokenRegistry<T>;
+	RegistryToken(TokenRegistry<T>* in_registry, uint32_t in_slot)
+		: m_registry(in_registry)
+		, m_slot(in_slot)
+	{
+	}
+
+	TokenRegistry<T>* m_registry = nullptr;
+	uint32_t m_slot = 0; // Stable handle to the token's columns (which move as the registry is sorted)
+};
+
+/// @brief Container for the token data of many lists (e.g. a modifier list per entity) that can be queried in batches
+/// @details Each list is identified by a @ref tTokenListId, and each token is a @ref RegistryToken scope guard that holds
+/// arithmetic data. Token data for every list is stored in contiguous struct-of-arrays columns (data, list id and handle),
+/// rather than in a separate container per list, so a per-frame system can evaluate every list with a single pass over
+/// memory. GetMins(), GetMaxes() and GetSums() fill one result per list id, and use SSE2 for float and double data.
+/// 
+/// Taking and releasing a token are O(1) (an append and a swap-remove). The columns are regrouped by list with a counting
+/// sort (O(tokens + lists)) on the first query after the set of tokens has changed, so queries are cheapest when tokens
+/// change less often than they are queried. Each query then reduces the contiguous run of data of each list.
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// TokenRegistry<float> m_speedMultipliers; // One list per entity (see Entity::speedListId)
+/// 
+/// void UpdateMovement() // Called once per frame
+/// {
+/// 	m_speedMultipliers.GetMins(m_minSpeedMultipliers, 1.0f); // Lists without tokens report 1.0f
+/// 	for(Entity& entity : m_entities)
+/// 	{
+/// 		entity.Move(entity.baseSpeed * m_minSpeedMultipliers[entity.speedListId]);
+/// 	}
+/// }
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// A registry cannot be copied or moved, and every token must be released before it is destroyed.
+template <typename T>
+class TokenRegistry
+{
+	static_assert(std::is_arithmetic<T>::value, "TokenRegistry data must be an arithmetic type");
+
+public:
+	static constexpr tTokenListId k_invalidListId = UINT32_MAX; ///< List id of tokens whose list has been destroyed
+
+	TokenRegistry() = default; /// Default constructor
+	~TokenRegistry() /// Destructor
+	{
+		SQUID_NOTHROW_CHECK(m_values.empty(), "TokenRegistry destroyed while tokens are still held");
+	}
+	TokenRegistry(const TokenRegistry&) = delete; // Guards refer to the registry by address
+	TokenRegistry& operator=(const TokenRegistry&) = delete;
+
+	/// Creates an empty list and returns its id (the ids of destroyed lists are reused)
+	tTokenListId CreateList()
+	{
+		tTokenListId listId;
+		if(m_freeListIds.size())
+		{
+			listId = m_freeListIds.back();
+			m_freeListIds.pop_back();
+		}
+		else
+		{
+			listId = (tTokenListId)m_listCounts.size();
+			m_listCounts.push_back(0);
+			m_isListAlive.push_back(false);
+		}
+		m_isListAlive[listId] = true;
+		return listId;
+	}
+
+	/// Destroys a list (tokens that are still held in it are detached, and no longer count towards any list)
+	void DestroyList(tTokenListId in_listId)
+	{
+		SQUID_RUNTIME_CHECK(IsListAlive(in_listId), "Cannot destroy a token list that does not exist");
+		if(m_listCounts[in_listId] > 0)
+		{
+			for(tTokenListId& listId : m_listIds)
+			{
+				if(listId == in_listId)
+				{
+					listId = k_invalidListId;
+				}
+			}
+			m_listCounts[in_listId] = 0;
+			m_isSorted = false;
+		}
+		m_isListAlive[in_listId] = false;
+		m_freeListIds.push_back(in_listId);
+	}
+
+	/// Returns whether a list with the specified id exists
+	bool IsListAlive(tTokenListId in_listId) const
+	{
+		return in_listId < m_isListAlive.size() && m_isListAlive[in_listId];
+	}
+
+	/// Returns one more than the highest list id ever created (the number of results filled by each batch query)
+	size_t GetNumListIds() const
+	{
+		return m_listCounts.size();
+	}
+
+	/// Take a token with the specified debug name and data in a list (held until the returned guard is destroyed or released)
+	SQUID_NODISCARD RegistryToken<T> TakeToken(tTokenListId in_listId, TokenName in_name, T in_data)
+	{
+		SQUID_RUNTIME_CHECK(IsListAlive(in_listId), "Cannot take a token in a token list that does not exist");
+		uint32_t slot;
+		if(m_freeSlots.size())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			slot = (uint32_t)m_slotIdxs.size();
+			m_slotIdxs.push_back(0);
+		}
+		m_slotIdxs[slot] = (uint32_t)m_values.size();
+		m_values.push_back(in_data);
+		m_listIds.push_back(in_listId);
+		m_slots.push_back(slot);
+#if SQUID_ENABLE_TOKEN_NAMES
+		m_names.push_back(in_name);
+#else
+		(void)in_name;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+		++m_listCounts[in_listId];
+		m_isSorted = false;
+		return RegistryToken<T>(this, slot);
+	}
+
+	/// Returns whether a list has any live tokens
+	bool HasTokens(tTokenListId in_listId) const
+	{
+		return in_listId < m_listCounts.size() && m_listCounts[in_listId] > 0;
+	}
+
+	/// Returns the number of live tokens in a list
+	uint32_t GetNumTokens(tTokenListId in_listId) const
+	{
+		return in_listId < m_listCounts.size() ? m_listCounts[in_listId] : 0;
+	}
+
+	/// Returns the number of live tokens across all lists (including detached tokens)
+	size_t GetTotalNumTokens() const
+	{
+		return m_values.size();
+	}
+
+	/// Returns the smallest data from the live tokens in a list
+	std::optional<T> GetMin(tTokenListId in_listId) const
+	{
+		return HasTokens(in_listId) ? ReduceMinMax<false>(GetListData(in_listId), m_listCounts[in_listId]) : std::optional<T>{};
+	}
+
+	/// Returns the largest data from the live tokens in a list
+	std::optional<T> GetMax(tTokenListId in_listId) const
+	{
+		return HasTokens(in_listId) ? ReduceMinMax<true>(GetListData(in_listId), m_listCounts[in_listId]) : std::optional<T>{};
+	}
+
+	/// Returns the sum of the data from the live tokens in a list (0 if there are no live tokens)
+	double GetSum(tTokenListId in_listId) const
+	{
+		return HasTokens(in_listId) ? ReduceSum(GetListData(in_listId), m_listCounts[in_listId]) : 0.0;
+	}
+
+	/// Fills @p out_mins (indexed by list id) with the smallest data in every list (or @p in_emptyValue, for lists with no live tokens)
+	void GetMins(std::vector<T>& out_mins, T in_emptyValue = T()) const
+	{
+		BatchReduce(out_mins, in_emptyValue, [](const T* in_values, uint32_t in_count) { return ReduceMinMax<false>(in_values, in_count); });
+	}
+
+	/// Fills @p out_maxes (indexed by list id) with the largest data in every list (or @p in_emptyValue, for lists with no live tokens)
+	void GetMaxes(std::vector<T>& out_maxes, T in_emptyValue = T()) const
+	{
+		BatchReduce(out_maxes, in_emptyValue, [](const T* in_values, uint32_t in_count) { return ReduceMinMax<true>(in_values, in_count); });
+	}
+
+	/// Fills @p out_sums (indexed by list id) with the sum of the data in every list (0 for lists with no live tokens)
+	void GetSums(std::vector<double>& out_sums) const
+	{
+		BatchReduce(out_sums, 0.0, [](const T* in_values, uint32_t in_count) { return ReduceSum(in_values, in_count); });
+	}
+
+	/// Returns a debug string containing a list of the debug names of all live tokens in a list
+	std::string GetDebugString(tTokenListId in_listId) const
+	{
+		if(!HasTokens(in_listId))
+		{
+			return "[no tokens]";
+		}
+#if SQUID_ENABLE_TOKEN_NAMES
+		SortByList();
+		std::string debugStr;
+		for(uint32_t idx = m_listStarts[in_listId]; idx < m_listStarts[in_listId] + m_listCounts[in_listId]; ++idx)
+		{
+			if(debugStr.size() > 0)
+			{
+				debugStr += "\n";
+			}
+			debugStr += m_names[idx].GetString();
+		}
+		return debugStr;
+#else
+		return "[" + std::to_string(m_listCounts[in_listId]) + " token(s)]";
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	}
+
+private:
+	friend class RegistryToken<T>;
+
+	void RemoveToken(uint32_t in_slot)
+	{
+		// Swap-remove the token's columns
+		uint32_t idx = m_slotIdxs[in_slot];
+		if(m_listIds[idx] != k_invalidListId)
+		{
+			--m_listCounts[m_listIds[idx]];
+		}
+		uint32_t lastIdx = (uint32_t)m_values.size() - 1;
+		if(idx != lastIdx)
+		{
+			m_values[idx] = m_values[lastIdx];
+			m_listIds[idx] = m_listIds[lastIdx];
+			m_slots[idx] = m_slots[lastIdx];
+#if SQUID_ENABLE_TOKEN_NAMES
+			m_names[idx] = m_names[lastIdx];
+#endif //SQUID_ENABLE_TOKEN_NAMES
+			m_slotIdxs[m_slots[idx]] = idx;
+			m_isSorted = false;
+		}
+		m_values.pop_back();
+		m_listIds.pop_back();
+		m_slots.pop_back();
+#if SQUID_ENABLE_TOKEN_NAMES
+		m_names.pop_back();
+#endif //SQUID_ENABLE_TOKEN_NAMES
+		m_freeSlots.push_back(in_slot);
+	}
+	void SortByList() const
+	{
+		if(m_isSorted)
+		{
+			return;
+		}
+
+		// Compute the start of each list's run (detached tokens are placed after the last list)
+		size_t numLists = m_listCounts.size();
+		m_listStarts.resize(numLists + 1);
+		uint32_t start = 0;
+		for(size_t listId = 0; listId < numLists; ++listId)
+		{
+			m_listStarts[listId] = start;
+			start += m_listCounts[listId];
+		}
+		m_listStarts[numLists] = start;
+
+		// Counting-sort the columns into the scratch columns, then swap them in
+		size_t numTokens = m_values.size();
+		m_sortCursors.assign(m_listStarts.begin(), m_listStarts.end());
+		m_sortValues.resize(numTokens);
+		m_sortListIds.resize(numTokens);
+		m_sortSlots.resize(numTokens);
+#if SQUID_ENABLE_TOKEN_NAMES
+		m_sortNames.resize(numTokens);
+#endif //SQUID_ENABLE_TOKEN_NAMES
+		for(size_t idx = 0; idx < numTokens; ++idx)
+		{
+			tTokenListId listId = m_listIds[idx];
+			uint32_t sortedIdx = m_sortCursors[listId == k_invalidListId ? numLists : listId]++;
+			m_sortValues[sortedIdx] = m_values[idx];
+			m_sortListIds[sortedIdx] = listId;
+			m_sortSlots[sortedIdx] = m_slots[idx];
+#if SQUID_ENABLE_TOKEN_NAMES
+			m_sortNames[sortedIdx] = m_names[idx];
+#endif //SQUID_ENABLE_TOKEN_NAMES
+		}
+		std::swap(m_values, m_sortValues);
+		std::swap(m_listIds, m_sortListIds);
+		std::swap(m_slots, m_sortSlots);
+#if SQUID_ENABLE_TOKEN_NAMES
+		std::swap(m_names, m_sortNames);
+#endif //SQUID_ENABLE_TOKEN_NAMES
+		for(uint32_t idx = 0; idx < (uint32_t)numTokens; ++idx)
+		{
+			m_slotIdxs[m_slots[idx]] = idx;
+		}
+		m_isSorted = true;
+	}
+	const T* GetListData(tTokenListId in_listId) const
+	{
+		SortByList();
+		return m_values.data() + m_listStarts[in_listId];
+	}
+	template <typename tResult, typename tReduceFn>
+	void BatchReduce(std::vector<tResult>& out_results, tResult in_emptyValue, tReduceFn in_reduceFn) const
+	{
+		SortByList();
+		size_t numLists = m_listCounts.size();
+		out_results.resize(numLists);
+		for(size_t listId = 0; listId < numLists; ++listId)
+		{
+			uint32_t count = m_listCounts[listId];
+			out_results[listId] = count ? in_reduceFn(m_values.data() + m_listStarts[listId], count) : in_emptyValue;
+		}
+	}
+	template <bool tIsMax>
+	static T ReduceMinMax(const T* in_values, uint32_t in_count)
+	{
+		// Returns the smallest (or largest) of 1 or more values
+		T result = in_values[0];
+		uint32_t i = 1;
+#if SQUID_HAS_SSE2
+		if constexpr(std::is_same<T, float>::value)
+		{
+			if(in_count >= 8)
+			{
+				__m128 acc = _mm_loadu_ps(in_values);
+				for(i = 4; i + 4 <= in_count; i += 4)
+				{
+					__m128 values = _mm_loadu_ps(in_values + i);
+					acc = tIsMax ? _mm_max_ps(acc, values) : _mm_min_ps(acc, values);
+				}
+				float lanes[4];
+				_mm_storeu_ps(lanes, acc);
+				result = tIsMax ? std::max({ lanes[0], lanes[1], lanes[2], lanes[3] }) : std::min({ lanes[0], lanes[1], lanes[2], lanes[3] });
+			}
+		}
+		else if constexpr(std::is_same<T, double>::value)
+		{
+			if(in_count >= 4)
+			{
+				__m128d acc = _mm_loadu_pd(in_values);
+				for(i = 2; i + 2 <= in_count; i += 2)
+				{
+					__m128d values = _mm_loadu_pd(in_values + i);
+					acc = tIsMax ? _mm_max_pd(acc, values) : _mm_min_pd(acc, values);
+				}
+				double lanes[2];
+				_mm_storeu_pd(lanes, acc);
+				result = tIsMax ? std::max(lanes[0], lanes[1]) : std::min(lanes[0], lanes[1]);
+			}
+		}
+#endif //SQUID_HAS_SSE2
+		for(; i < in_count; ++i) // Remainder (or all values, without SSE2 or for integer data)
+		{
+			result = tIsMax ? std::max(result, in_values[i]) : std::min(result, in_values[i]);
+		}
+		return result;
+	}
+	static double ReduceSum(const T* in_values, uint32_t in_count)
+	{
+		// Returns the sum of 1 or more values (accumulated in double precision, as with TokenList::GetSum())
+		double result = 0.0;
+		uint32_t i = 0;
+#if SQUID_HAS_SSE2
+		if constexpr(std::is_same<T, float>::value)
+		{
+			__m128d accLo = _mm_setzero_pd();
+			__m128d accHi = _mm_setzero_pd();
+			for(; i + 4 <= in_count; i += 4)
+			{
+				__m128 values = _mm_loadu_ps(in_values + i);
+				accLo = _mm_add_pd(accLo, _mm_cvtps_pd(values));
+				accHi = _mm_add_pd(accHi, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+			}
+			double lanes[2];
+			_mm_storeu_pd(lanes, _mm_add_pd(accLo, accHi));
+			result = lanes[0] + lanes[1];
+		}
+		else if constexpr(std::is_same<T, double>::value)
+		{
+			__m128d acc = _mm_setzero_pd();
+			for(; i + 2 <= in_count; i += 2)
+			{
+				acc = _mm_add_pd(acc, _mm_loadu_pd(in_values + i));
+			}
+			double lanes[2];
+			_mm_storeu_pd(lanes, acc);
+			result = lanes[0] + lanes[1];
+		}
+#endif //SQUID_HAS_SSE2
+		for(; i < in_count; ++i) // Remainder (or all values, without SSE2 or for integer data)
+		{
+			result += (double)in_values[i];
+		}
+		return result;
+	}
+
+	// Token columns (grouped into one contiguous run per list, in list id order, whenever m_isSorted is set)
+	mutable std::vector<T> m_values; // Data of each token
+	mutable std::vector<tTokenListId> m_listIds; // List of each token (k_invalidListId if its list was destroyed)
+	mutable std::vector<uint32_t> m_slots; // Slot of each token
+#if SQUID_ENABLE_TOKEN_NAMES
+	mutable std::vector<TokenName> m_names; // Debug name of each token
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	mutable std::vector<uint32_t> m_slotIdxs; // Column index of each slot's token (updated as the columns move)
+	std::vector<uint32_t> m_freeSlots;
+
+	// List columns (indexed by list id)
+	std::vector<uint32_t> m_listCounts; // Number of live tokens in each list
+	mutable std::vector<uint32_t> m_listStarts; // Column index of the first token in each list (valid while m_isSorted is set)
+	std::vector<uint8_t> m_isListAlive;
+	std::vector<tTokenListId> m_freeListIds;
+	mutable bool m_isSorted = true;
+
+	// Scratch columns for SortByList() (kept to avoid reallocating on every sort)
+	mutable std::vector<uint32_t> m_sortCursors;
+	mutable std::vector<T> m_sortValues;
+	mutable std::vector<tTokenListId> m_sortListIds;
+	mutable std::vector<uint32_t> m_sortSlots;
+#if SQUID_ENABLE_TOKEN_NAMES
+	mutable std::vector<TokenName> m_sortNames;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+};
+
+//--- ConcurrentTokenList ---//
+class ConcurrentTokenListBase;
+
+/// @brief Movable scope guard that holds one token in a ConcurrentTokenList (the token is released when the guard is destroyed)
+/// @details A guard may be moved to, and released on, any thread.
+class ConcurrentToken
+{
+public:
+	ConcurrentToken() = default; /// Default constructor (holds no token)
+	ConcurrentToken(ConcurrentToken&& in_other) noexcept /// Move constructor
+		: m_list(in_other.m_list)
+		, m_masks(in_other.m_masks)
+		, m_bit(in_other.m_bit)
+	{
+		in_other.m_list = nullptr;
+	}
+	ConcurrentToken& operator=(ConcurrentToken&& in_other) noexcept /// Move assignment operator
+	{
+		if(this != &in_other)
+		{
+			Release();
+			m_list = in_other.m_list;
+			m_masks = in_other.m_masks;
+			m_bit = in_other.m_bit;
+			in_other.m_list = nullptr;
+		}
+		return *this;
+	}
+	~ConcurrentToken() /// Destructor (releases the token)
+	{
+		Release();
+	}
+	ConcurrentToken(const ConcurrentToken&) = delete;
+	ConcurrentToken& operator=(const ConcurrentToken&) = delete;
+
+	/// Returns whether this guard holds a token
+	bool IsHeld() const
+	{
+		return m_list != nullptr;
+	}
+
+	/// Releases the token early (if it is held)
+	void Release();
+
+private:
+	friend class ConcurrentTokenListBase;
+	struct SlotMasks;
+	ConcurrentToken(ConcurrentTokenListBase* in_list, SlotMasks* in_masks, uint64_t in_bit)
+		: m_list(in_list)
+		, m_masks(in_masks)
+		, m_bit(in_bit)
+	{
+	}
+
+	ConcurrentTokenListBase* m_list = nullptr;
+	SlotMasks* m_masks = nullptr; // Masks of the group of 64 slots that holds the token
+	uint64_t m_bit = 0; // Bit of the token's slot within its group
+};
+
+/// @brief Point-in-time copy of the live tokens of a ConcurrentTokenList, with the same queries as a TokenList
+/// @details A snapshot is a plain (single-threaded) container. Reuse one snapshot across frames (via
+/// ConcurrentTokenList::TakeSnapshot()) to avoid reallocating its storage.
+template <typename T = void>
+class TokenSnapshot
+{
+public:
+	/// Returns whether the snapshot holds any tokens
+	bool HasTokens() const
+	{
+		return m_numTokens > 0;
+	}
+
+	/// Returns the number of tokens in the snapshot
+	size_t GetNumTokens() const
+	{
+		return m_numTokens;
+	}
+
+	/// Returns the data of every token in the snapshot (in no particular order)
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	const std::vector<U>& GetTokenData() const
+	{
+		return m_data;
+	}
+
+	/// Returns the smallest data in the snapshot
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	std::optional<U> GetMin() const
+	{
+		return m_data.size() ? *std::min_element(m_data.begin(), m_data.end()) : std::optional<U>{};
+	}
+
+	/// Returns the largest data in the snapshot
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	std::optional<U> GetMax() const
+	{
+		return m_data.size() ? *std::max_element(m_data.begin(), m_data.end()) : std::optional<U>{};
+	}
+
+	/// Returns the sum of the data in the snapshot (0 if there are no tokens)
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	double GetSum() const
+	{
+		double sum = 0.0;
+		for(const U& data : m_data)
+		{
+			sum += (double)data;
+		}
+		return sum;
+	}
+
+	/// Returns the arithmetic mean of the data in the snapshot
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	std::optional<double> GetMean() const
+	{
+		return m_data.size() ? GetSum() / m_data.size() : std::optional<double>{};
+	}
+
+	/// Returns whether the snapshot contains at least one token with the specified data
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	bool Contains(const U& in_searchData) const
+	{
+		return std::find(m_data.begin(), m_data.end(), in_searchData) != m_data.end();
+	}
+
+	/// Returns a debug string containing a list of the debug names of all tokens in the snapshot
+	std::string GetDebugString() const
+	{
+#if SQUID_ENABLE_TOKEN_NAMES
+		std::string debugStr;
+		for(const TokenName& name : m_names)
+		{
+			if(debugStr.size() > 0)
+			{
+				debugStr += "\n";
+			}
+			debugStr += name.GetString();
+		}
+		return debugStr.size() ? debugStr : "[no tokens]";
+#else
+		return m_numTokens ? "[" + std::to_string(m_numTokens) + " token(s)]" : "[no tokens]";
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	}
+
+private:
+	template <typename>
+	friend class ConcurrentTokenList;
+	using tStoredData = std::conditional_t<std::is_void<T>::value, char, T>;
+
+	void Clear()
+	{
+		m_numTokens = 0;
+		m_data.clear();
+#if SQUID_ENABLE_TOKEN_NAMES
+		m_names.clear();
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	}
+
+	size_t m_numTokens = 0;
+	std::vector<tStoredData> m_data; // (Unused for tokens without data)
+#if SQUID_ENABLE_TOKEN_NAMES
+	std::vector<TokenName> m_names;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+};
+
+/// @private Data-independent part of ConcurrentTokenList (token counting and slot masks)
+class ConcurrentTokenListBase
+{
+public:
+	/// Convenience conversion operator that calls HasTokens()
+	operator bool() const
+	{
+		return HasTokens();
+	}
+
+	/// Returns whether any tokens are held (wait-free)
+	bool HasTokens() const
+	{
+		return m_numTokens.load(std::memory_order_acquire) != 0;
+	}
+
+	/// Returns the number of tokens held (wait-free)
+	uint32_t GetNumTokens() const
+	{
+		return m_numTokens.load(std::memory_order_acquire);
+	}
+
+	/// @brief Awaiter function that waits until any tokens are held
+	/// @details Must be awaited on the thread that updates the awaiting task, but the list may change on any thread. The
+	/// waiting task is treated as asleep by its task manager, so a scheduler that sleeps between updates must be woken
+	/// by the wake function (see SetWakeFn()).
+	Task<> WaitUntilHasTokens() const
+	{
+		return WaitForCount(this, true);
+	}
+
+	/// @brief Awaiter function that waits until no tokens are held (e.g. until all background loads have finished)
+	/// @details Must be awaited on the thread that updates the awaiting task, but the list may change on any thread. The
+	/// waiting task is treated as asleep by its task manager, so a scheduler that sleeps between updates must be woken
+	/// by the wake function (see SetWakeFn()).
+	Task<> WaitUntilEmpty() const
+	{
+		return WaitForCount(this, false);
+	}
+
+	/// @brief Sets a function to be called (from whichever thread took or released the token) each time the list goes
+	/// from holding no tokens to holding some, or back
+	/// @details Typically used to wake a sleeping scheduler, e.g. [&runLoop] { runLoop.Wake(); }
+	void SetWakeFn(std::function<void()> in_wakeFn)
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_wakeFn = std::move(in_wakeFn);
+	}
+
+protected:
+	friend class ConcurrentToken;
+	using SlotMasks = ConcurrentToken::SlotMasks;
+
+	ConcurrentTokenListBase() = default;
+	~ConcurrentTokenListBase()
+	{
+		SQUID_NOTHROW_CHECK(m_numTokens.load() == 0, "ConcurrentTokenList destroyed while tokens are still held");
+	}
+
+	// Reserves the lowest free slot in a group (returns its bit, or 0 if every slot is reserved)
+	static uint64_t ReserveSlot(SlotMasks& io_masks);
+	static uint32_t GetBitIdx(uint64_t in_bit)
+	{
+		uint32_t bitIdx = 0;
+		while((in_bit >> bitIdx) != 1)
+		{
+			++bitIdx;
+		}
+		return bitIdx;
+	}
+	ConcurrentToken PublishSlot(SlotMasks& io_masks, uint64_t in_bit);
+	void CallWakeFn()
+	{
+		std::function<void()> wakeFn;
+		{
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+			wakeFn = m_wakeFn;
+		}
+		if(wakeFn)
+		{
+			wakeFn();
+		}
+	}
+
+	std::atomic<uint32_t> m_numTokens = 0;
+	std::mutex m_wakeMutex;
+	std::function<void()> m_wakeFn; // Called when the list becomes empty or non-empty (see SetWakeFn())
+
+private:
+	static Task<> WaitForCount(const ConcurrentTokenListBase* in_list, bool in_hasTokens)
+	{
+		TASK_NAME(__FUNCTION__);
+		co_await ExternalReadyFn{ [in_list, in_hasTokens] { return in_list->HasTokens() == in_hasTokens; } };
+	}
+};
+
+/// @private Occupancy masks of a group of 64 slots
+struct ConcurrentToken::SlotMasks
+{
+	std::atomic<uint64_t> reserved = 0; // Slots claimed by a token (including slots whose data is still being written)
+	std::atomic<uint64_t> published = 0; // Slots whose token is visible to readers
+};
+
+/// @brief Thread-safe variant of TokenList, whose tokens can be taken and released on any thread
+/// @details Tokens are @ref ConcurrentToken scope guards. Taking a token is lock-free (it claims a free slot with a
+/// compare-and-swap), releasing a token is wait-free, and HasTokens() and GetNumTokens() are single atomic loads.
+/// Aggregate queries are made on a @ref TokenSnapshot, which copies the data of every live token without taking a lock:
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+/// 
+/// ConcurrentTokenList<> m_loadingTokens;
+/// 
+/// void LoadChunkJob() // Runs on a worker thread
+/// {
+/// 	auto loadingToken = m_loadingTokens.TakeToken("LoadChunkJob"); // Released when the job finishes
+/// 	...
+/// }
+/// 
+/// Task<> EnterLevelTask() // Runs on the main thread
+/// {
+/// 	co_await m_loadingTokens.WaitUntilEmpty();
+/// 	...
+/// }
+/// 
+/// m_loadingTokens.SetWakeFn([&runLoop] { runLoop.Wake(); }); // Wake the main thread's run loop when loads finish
+/// 
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// 
+/// Token data must be trivially copyable, and is stored in a std::atomic<T> per slot (so operations are only lock-free
+/// for data types that std::atomic implements without a lock, such as arithmetic types and pointers). A snapshot taken
+/// while other threads are changing the list includes every token that was held throughout the snapshot, and may or may
+/// not include tokens that were taken or released during it. Slots are allocated in groups of 64, in chunks that double
+/// in size as the list grows, and are not freed until the list is destroyed. A concurrent list cannot be copied or
+/// moved, and every token must be released before it is destroyed.
+template <typename T = void>
+class ConcurrentTokenList : public ConcurrentTokenListBase
+{
+	static_assert(std::is_void<T>::value || std::is_trivially_copyable<T>::value, "ConcurrentTokenList data must be trivially copyable");
+
+public:
+	ConcurrentTokenList() = default; /// Default constructor
+	~ConcurrentTokenList() /// Destructor
+	{
+		for(std::atomic<Chunk*>& chunk : m_chunks)
+		{
+			delete chunk.load();
+		}
+	}
+	ConcurrentTokenList(const ConcurrentTokenList&) = delete; // Guards refer to the list by address
+	ConcurrentTokenList& operator=(const ConcurrentTokenList&) = delete;
+
+	/// Take a token with the specified debug name (held until the returned guard is destroyed or released)
+	template <typename U = T, typename std::enable_if_t<std::is_void<U>::value>* = nullptr>
+	SQUID_NODISCARD ConcurrentToken TakeToken(TokenName in_name)
+	{
+		return TakeTokenInternal(in_name, 0);
+	}
+
+	/// Take a token with the specified debug name and associated data (held until the returned guard is destroyed or released)
+	template <typename U = T, typename std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+	SQUID_NODISCARD ConcurrentToken TakeToken(TokenName in_name, U in_data)
+	{
+		return TakeTokenInternal(in_name, in_data);
+	}
+
+	/// Copies the live tokens into a snapshot (reusing the snapshot's storage)
+	void TakeSnapshot(TokenSnapshot<T>& out_snapshot) const
+	{
+		out_snapshot.Clear();
+		for(uint32_t chunkIdx = 0; chunkIdx < k_maxChunks; ++chunkIdx)
+		{
+			const Chunk* chunk = m_chunks[chunkIdx].load(std::memory_order_acquire);
+			if(!chunk)
+			{
+				break; // Chunks are installed in order
+			}
+			for(uint32_t groupIdx = 0; groupIdx < chunk->numGroups; ++groupIdx)
+			{
+				uint64_t published = chunk->masks[groupIdx].published.load(std::memory_order_acquire);
+				for(; published; published &= published - 1)
+				{
+					const Slot& slot = chunk->slots[groupIdx * 64 + GetBitIdx(published & (0 - published))];
+					++out_snapshot.m_numTokens;
+					if constexpr(!std::is_void<T>::value)
+					{
+						out_snapshot.m_data.push_back(slot.data.load(std::memory_order_relaxed));
+					}
+#if SQUID_ENABLE_TOKEN_NAMES
+					out_snapshot.m_names.push_back(slot.name.load(std::memory_order_relaxed));
+#endif //SQUID_ENABLE_TOKEN_NAMES
+				}
+			}
+		}
+	}
+
+	/// Returns a snapshot of the live tokens
+	TokenSnapshot<T> GetSnapshot() const
+	{
+		TokenSnapshot<T> snapshot;
+		TakeSnapshot(snapshot);
+		return snapshot;
+	}
+
+	/// Returns a debug string containing a list of the debug names of all live tokens
+	std::string GetDebugString() const
+	{
+		return GetSnapshot().GetDebugString();
+	}
+
+private:
+	using tStoredData = typename TokenSnapshot<T>::tStoredData;
+	static constexpr uint32_t k_maxChunks = 26; // Chunk i holds 64 * 2^i slots
+
+	struct Slot
+	{
+		std::atomic<tStoredData> data = {}; // (Atomic, as a snapshot may read a slot while it is being reused)
+#if SQUID_ENABLE_TOKEN_NAMES
+		std::atomic<TokenName> name = {};
+#endif //SQUID_ENABLE_TOKEN_NAMES
+	};
+	struct Chunk
+	{
+		Chunk(uint32_t in_numGroups)
+			: numGroups(in_numGroups)
+			, masks(new SlotMasks[in_numGroups])
+			, slots(new Slot[in_numGroups * 64])
+		{
+		}
+		const uint32_t numGroups;
+		std::unique_ptr<SlotMasks[]> masks;
+		std::unique_ptr<Slot[]> slots;
+	};
+
+	ConcurrentToken TakeTokenInternal(TokenName in_name, tStoredData in_data)
+	{
+		for(uint32_t chunkIdx = 0; chunkIdx < k_maxChunks; ++chunkIdx)
+		{
+			Chunk* chunk = GetOrCreateChunk(chunkIdx);
+			for(uint32_t groupIdx = 0; groupIdx < chunk->numGroups; ++groupIdx)
+			{
+				SlotMasks& masks = chunk->masks[groupIdx];
+				if(uint64_t bit = ReserveSlot(masks))
+				{
+					// Write the slot while it is reserved (but not yet visible to readers), then publish it
+					Slot& slot = chunk->slots[groupIdx * 64 + GetBitIdx(bit)];
+					slot.data.store(in_data, std::memory_order_relaxed);
+#if SQUID_ENABLE_TOKEN_NAMES
+					slot.name.store(in_name, std::memory_order_relaxed);
+#else
+					(void)in_name;
+#endif //SQUID_ENABLE_TOKEN_NAMES
+					return PublishSlot(masks, bit);
+				}
+			}
+		}
+		SQUID_RUNTIME_CHECK(false, "ConcurrentTokenList is out of slots");
+		return {};
+	}
+	Chunk* GetOrCreateChunk(uint32_t in_chunkIdx)
+	{
+		Chunk* chunk = m_chunks[in_chunkIdx].load(std::memory_order_acquire);
+		if(!chunk)
+		{
+			// Race to install a new chunk (the losers delete theirs, and use the winner's)
+			Chunk* newChunk = new Chunk(1u << in_chunkIdx);
+			if(m_chunks[in_chunkIdx].compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				chunk = newChunk;
+			}
+			else
+			{
+				delete newChunk;
+			}
+		}
+		return chunk;
+	}
+
+	std::atomic<Chunk*> m_chunks[k_maxChunks] = {};
+};
+
+inline void ConcurrentToken::Release()
+{
+	if(!m_list)
+	{
+		return;
+	}
+	bool isLastToken = m_list->m_numTokens.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	m_masks->published.fetch_and(~m_bit, std::memory_order_release);
+	m_masks->reserved.fetch_and(~m_bit, std::memory_order_release);
+	if(isLastToken)
+	{
+		m_list->CallWakeFn();
+	}
+	m_list = nullptr;
+}
+inline uint64_t ConcurrentTokenListBase::ReserveSlot(SlotMasks& io_masks)
+{
+	uint64_t reserved = io_masks.reserved.load(std::memory_order_relaxed);
+	while(reserved != ~uint64_t(0))
+	{
+		uint64_t bit = ~reserved & (reserved + 1); // Lowest free slot
+		if(io_masks.reserved.compare_exchange_weak(reserved, reserved | bit, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return bit;
+		}
+	}
+	return 0;
+}
+inline ConcurrentToken ConcurrentTokenListBase::PublishSlot(SlotMasks& io_masks, uint64_t in_bit)
+{
+	io_masks.published.fetch_or(in_bit, std::memory_order_release);
+	if(m_numTokens.fetch_add(1, std::memory_order_acq_rel) == 0)
+	{
+		CallWakeFn();
+	}
+	return ConcurrentToken(this, &io_masks, in_bit);
+}
 
 NAMESPACE_SQUID_END
 
@@ -3,6 +3,8 @@
 #include <chrono>
 #include <atomic>
 
+#include "FastClock.h"
+
 //--- Time System ---//
 class TimeSystem
 {
@@ -28,24 +30,24 @@ public:
 private:
 	TimeSystem()
 	{
-		m_startTimePoint = std::chrono::steady_clock::now();
+		m_startTimePoint = NAMESPACE_SQUID::FastClock::now();
 	}
 	void _UpdateTime()
 	{
-		std::chrono::steady_clock::time_point curTimePoint = std::chrono::steady_clock::now();
+		NAMESPACE_SQUID::FastClock::time_point curTimePoint = NAMESPACE_SQUID::FastClock::now(); // Reads the CPU timestamp counter (cheaper than steady_clock)
 		std::chrono::duration<double> span = std::chrono::duration_cast<std::chrono::duration<double>>(curTimePoint - m_startTimePoint);
-		m_time = span.count();
+		m_time.store(span.count(), std::memory_order_relaxed); // (Readers only need the latest value, not ordering with other memory)
 	}
 	double _GetTimeSince(double in_time) const
 	{
-		return m_time - in_time;
+		return m_time.load(std::memory_order_relaxed) - in_time;
 	}
 	double _GetTime() const
 	{
-		return m_time;
+		return m_time.load(std::memory_order_relaxed);
 	}
 
-	std::chrono::steady_clock::time_point m_startTimePoint;
+	NAMESPACE_SQUID::FastClock::time_point m_startTimePoint;
 	std::atomic<double> m_time;
 	static TimeSystem* s_timeSys;
 };
@@ -1,12 +1,22 @@
 #include "Task.h"
 #include "TimeSystem.h"
 #include "TaskFSM.h"
+#include "TaskManager.h"
+#include "TaskReactor.h"
+#include "TaskTimeStreams.h"
+#include "TokenList.h"
+
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
 
 // User-defined GetGlobalTime() is required to link Task.h
 NAMESPACE_SQUID_BEGIN
 tTaskTime GetGlobalTime()
 {
-	return (tTaskTime)TimeSystem::GetTime();
+	return TaskTimeFromSeconds(TimeSystem::GetTime());
 }
 NAMESPACE_SQUID_END
 
@@ -22,7 +32,7 @@ Task<> PeriodicTask(float in_duration)
 {
 	TASK_NAME(__FUNCTION__);
 	printf("Periodic task\n");
-	co_await WaitSeconds(in_duration);
+	co_await WaitSeconds(TaskTimeFromSeconds(in_duration));
 }
 
 Task<> TestFsmTask()
@@ -36,7 +46,7 @@ Task<> TestFsmTask()
 		printf("Lambda state!\n");
 
 		auto stopCtx = co_await GetStopContext();
-		co_await WaitSeconds(in_duration).CancelIf([&] { return stopCtx.IsStopRequested(); });
+		co_await WaitSeconds(TaskTimeFromSeconds(in_duration)).CancelIf([&] { return stopCtx.IsStopRequested(); });
 	};
 
 	auto idleState = fsm.State("Idle", IdleTask);
@@ -74,11 +84,324 @@ void TestTaskFSM()
 	}
 }
 
+Task<> GroupMemberTask(int32_t in_idx)
+{
+	TASK_NAME(__FUNCTION__);
+	co_await WaitForever().CancelIfStopRequested();
+	printf("Group member %d stopped\n", in_idx);
+}
+
+void TestTaskGroups()
+{
+	constexpr tTaskTag k_groupTag = MakeTaskTag("TestGroup");
+	TaskManager taskMgr;
+	for(int32_t i = 0; i < 3; ++i)
+	{
+		taskMgr.RunManaged(GroupMemberTask(i), k_groupTag);
+	}
+	auto untaggedTask = taskMgr.Run(WaitForever());
+	taskMgr.Update();
+	printf("Group count: %d\n", (int32_t)taskMgr.GetTaskGroupCount(k_groupTag));
+
+	auto fenceTask = taskMgr.StopTaskGroup(k_groupTag);
+	while(fenceTask.Resume() != eTaskStatus::Done)
+	{
+		taskMgr.Update();
+	}
+	printf("Group count after stop: %d (untagged task done: %d)\n", (int32_t)taskMgr.GetTaskGroupCount(k_groupTag), untaggedTask.IsDone());
+}
+
+Task<> SpawnedTask()
+{
+	TASK_NAME(__FUNCTION__);
+	co_await WaitForever();
+}
+
+void BenchmarkTaskSpawning()
+{
+	// Compare spawning tasks one at a time with spawning them in bulk (as at level load)
+	constexpr size_t k_numTasks = 10000;
+	auto TimeSpawn = [](const char* in_label, auto in_spawnFn) {
+		TaskManager taskMgr;
+		auto startTime = std::chrono::steady_clock::now();
+		in_spawnFn(taskMgr);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+		printf("%s: %.3fms\n", in_label, elapsed.count());
+	};
+	TimeSpawn("RunManaged() x10000", [](TaskManager& in_taskMgr) {
+		for(size_t i = 0; i < k_numTasks; ++i)
+		{
+			in_taskMgr.RunManaged(SpawnedTask());
+		}
+	});
+#if SQUID_ENABLE_TASK_FRAME_POOL
+	ReserveTaskFrames(k_numTasks, GetTaskFrameSize([] { return SpawnedTask(); }));
+#endif //SQUID_ENABLE_TASK_FRAME_POOL
+	TimeSpawn("Reserve() + RunManyManaged() x10000", [](TaskManager& in_taskMgr) {
+		std::vector<Task<>> tasks;
+		tasks.reserve(k_numTasks);
+		for(size_t i = 0; i < k_numTasks; ++i)
+		{
+			tasks.push_back(SpawnedTask());
+		}
+		in_taskMgr.Reserve(k_numTasks);
+		in_taskMgr.RunManyManaged(tasks);
+	});
+}
+
+template <typename tTimeFn>
+Task<> SimulatedSpawnTask(int32_t& io_numSpawns, tTimeFn in_timeFn)
+{
+	TASK_NAME(__FUNCTION__);
+	while(true)
+	{
+		co_await WaitSeconds(TaskTimeFromSeconds(30.0), in_timeFn);
+		++io_numSpawns;
+	}
+}
+
+void TestFastForward()
+{
+	// Simulate 8 hours of spawns (one every 30 seconds) in virtual time
+	VirtualTimeStream simTime;
+	TaskManager taskMgr;
+	taskMgr.SetFastForwardTimeStream(&simTime);
+	int32_t numSpawns = 0;
+	taskMgr.RunManaged(SimulatedSpawnTask(numSpawns, simTime.GetTimeFn()));
+	int32_t numUpdates = 0;
+	while(simTime.GetTime() < TaskTimeFromSeconds(8.0 * 60.0 * 60.0))
+	{
+		taskMgr.Update();
+		++numUpdates;
+	}
+	printf("Simulated %.0f seconds: %d spawns in %d updates\n", TaskTimeToSeconds(simTime.GetTime()), numSpawns, numUpdates);
+}
+
+Task<> GameTimeWaitTask(ScaledTimeStream& in_gameTime, int32_t& io_numDone)
+{
+	TASK_NAME(__FUNCTION__);
+	co_await WaitSeconds(TaskTimeFromSeconds(1.0), in_gameTime);
+	++io_numDone;
+}
+
+void TestTimeStreams()
+{
+	// Wait one second of game time, while game time runs at half-speed and is then paused for half a second
+	VirtualTimeStream realTime;
+	TimeStreamRegistry timeStreams;
+	ScaledTimeStream& gameTime = timeStreams.AddTimeStream("Game", realTime.GetTimeFn());
+	TaskManager taskMgr;
+	int32_t numDone = 0;
+	for(int32_t i = 0; i < 1000; ++i)
+	{
+		taskMgr.RunManaged(GameTimeWaitTask(gameTime, numDone));
+	}
+	taskMgr.Update(); // Start the waits at time zero
+	gameTime.SetTimeScale(0.5f);
+	for(int32_t frame = 1; numDone == 0; ++frame) // 10 frames per second
+	{
+		realTime.Advance(TaskTimeFromSeconds(0.1));
+		if(frame == 10)
+		{
+			gameTime.Pause();
+		}
+		else if(frame == 15)
+		{
+			gameTime.Unpause();
+		}
+		timeStreams.Snapshot();
+		taskMgr.Update();
+	}
+	printf("Game-time waits finished after %.1f real seconds: %d done\n", TaskTimeToSeconds(realTime.GetTime()), numDone);
+
+	// Streams derived from game time inherit its scale and pause state (so their wake times are measured in real time)
+	ScaledTimeStream& cutsceneTime = timeStreams.AddTimeStream("Cutscene", gameTime);
+	cutsceneTime.SetTimeScale(0.5f);
+	taskMgr.RunManaged(GameTimeWaitTask(cutsceneTime, numDone));
+	taskMgr.Update();
+	TaskWakeTime wakeTime = taskMgr.GetNextWakeTime();
+	gameTime.Pause();
+	TaskWakeTime pausedWakeTime = taskMgr.GetNextWakeTime();
+	gameTime.Unpause();
+	printf("Cutscene wait wakes after %.1f real seconds (never while game time is paused: %d)\n",
+		TaskTimeToSeconds(wakeTime.timeRemaining.value_or(0)), pausedWakeTime.type == TaskWakeTime::eType::Never);
+
+	// A task that pauses its own group before it starts waiting keeps its timer frozen until the group is unpaused
+	constexpr tTaskTag k_menuTag = MakeTaskTag("Menu");
+	bool isMenuWaitDone = false;
+	taskMgr.RunManaged([](TaskManager& in_taskMgr, ScaledTimeStream& in_gameTime, bool& io_isDone) -> Task<> {
+		TASK_NAME("MenuWaitTask");
+		in_taskMgr.PauseTaskGroup(MakeTaskTag("Menu"));
+		co_await WaitSeconds(TaskTimeFromSeconds(1.0), in_gameTime);
+		io_isDone = true;
+	}(taskMgr, gameTime, isMenuWaitDone), k_menuTag);
+	taskMgr.Update();
+	realTime.Advance(TaskTimeFromSeconds(4.0));
+	timeStreams.Snapshot();
+	taskMgr.UnpauseTaskGroup(k_menuTag);
+	taskMgr.Update();
+	printf("Wait started while paused done right after unpausing: %d\n", isMenuWaitDone);
+}
+
+void TestTokenList()
+{
+	// A token can belong to several lists, and each list aggregates the data of its live tokens
+	TokenList<float> speedMultipliers;
+	TokenList<float> slowEffects;
+	auto hasteToken = speedMultipliers.TakeToken("Haste", 1.5f);
+	auto slowToken = speedMultipliers.TakeToken("Slow", 0.5f);
+	auto chillToken = speedMultipliers.TakeToken("Chill", 0.75f);
+	slowEffects.AddToken(slowToken);
+	slowEffects.AddToken(chillToken);
+	hasteToken = nullptr; // Releasing the last reference removes the token from its list
+	speedMultipliers.SetData(slowToken, 0.25f); // Updates the aggregates of every list the token belongs to
+	printf("Speed multipliers: min %.2f, max %.2f, mean %.2f, contains 0.5: %d (slow effects: max %.2f, %d token(s))\n",
+		speedMultipliers.GetMin().value(), speedMultipliers.GetMax().value(), speedMultipliers.GetMean().value(),
+		speedMultipliers.Contains(0.5f), slowEffects.GetMax().value(), (int32_t)slowEffects.GetNumTokens());
+	chillToken = nullptr;
+	slowEffects.RemoveToken(slowToken);
+	printf("After removals: speed max %.2f, slow effects empty: %d\n", speedMultipliers.GetMax().value(), !slowEffects.HasTokens());
+
+	// Timed tokens are held by the list itself, and expire as time passes in a time-stream
+	VirtualTimeStream realTime;
+	TimeStream gameTime(realTime.GetTimeFn());
+	TokenList<> stunTokens;
+	stunTokens.TakeTokenFor("Stun", TaskTimeFromSeconds(2.0), gameTime);
+	realTime.Advance(TaskTimeFromSeconds(1.0));
+	gameTime.Snapshot();
+	bool isStunnedAfter1s = stunTokens.HasTokens();
+	realTime.Advance(TaskTimeFromSeconds(1.0));
+	gameTime.Snapshot();
+	printf("Stunned after 1s: %d, after 2s: %d\n", isStunnedAfter1s, stunTokens.HasTokens());
+
+	// A counter only tracks how many tokens are held
+	TokenCounter busyCounter;
+	{
+		auto busyToken = busyCounter.TakeToken("Busy");
+		printf("Counter tokens while held: %d, ", (int32_t)busyCounter.GetNumTokens());
+	}
+	printf("after release: %d\n", (int32_t)busyCounter.GetNumTokens());
+
+	// A registry stores the data of many lists in shared columns, and evaluates them all in one pass
+	TokenRegistry<float> registry;
+	tTokenListId listA = registry.CreateList();
+	tTokenListId listB = registry.CreateList();
+	auto tokenA = registry.TakeToken(listA, "A", 2.0f);
+	auto tokenB1 = registry.TakeToken(listB, "B1", 3.0f);
+	auto tokenB2 = registry.TakeToken(listB, "B2", 4.0f);
+	registry.DestroyList(listB); // Detaches B1 and B2
+	tTokenListId listC = registry.CreateList(); // Reuses the destroyed list's id
+	auto tokenC = registry.TakeToken(listC, "C", 1.0f);
+	std::vector<float> maxes;
+	registry.GetMaxes(maxes, 0.0f);
+	printf("Registry maxes after DestroyList(): A %.1f, C %.1f (reused id: %d, C tokens: %d)\n",
+		maxes[listA], maxes[listC], listC == listB, (int32_t)registry.GetNumTokens(listC));
+}
+
+void TestConcurrentTokenList()
+{
+	// Wait on the main thread until background jobs have released their loading tokens
+	ConcurrentTokenList<float> loadingTokens;
+	TaskManager taskMgr;
+	TaskRunLoop runLoop(taskMgr);
+	loadingTokens.SetWakeFn([&runLoop] { runLoop.Wake(); }); // The last job to finish wakes the sleeping run loop
+	std::vector<std::thread> jobs;
+	for(int32_t i = 0; i < 4; ++i)
+	{
+		// Each job releases its token on its own thread when it finishes
+		jobs.emplace_back([loadingToken = loadingTokens.TakeToken("LoadJob", (float)i), i]() mutable {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10 * (i + 1)));
+			loadingToken.Release();
+		});
+	}
+	auto waitTask = taskMgr.Run([](ConcurrentTokenList<float>& in_loadingTokens, TaskRunLoop& in_runLoop) -> Task<> {
+		TASK_NAME("WaitForLoadsTask");
+		co_await in_loadingTokens.WaitUntilEmpty();
+		in_runLoop.Stop();
+	}(loadingTokens, runLoop));
+	int32_t numUpdates = 0;
+	TokenSnapshot<float> snapshot;
+	runLoop.Run([&] {
+		loadingTokens.TakeSnapshot(snapshot);
+		++numUpdates;
+		return true;
+	});
+	for(auto& job : jobs)
+	{
+		job.join();
+	}
+	loadingTokens.SetWakeFn(nullptr);
+	printf("Background loads finished after %d updates (last snapshot: %d token(s))\n", numUpdates, (int32_t)snapshot.GetNumTokens());
+}
+
+#if defined(__linux__)
+Task<> ReadSocketTask(TaskReactor& in_reactor, int in_fd)
+{
+	TASK_NAME(__FUNCTION__);
+	char buf[64] = {};
+	while(true)
+	{
+		uint32_t events = co_await in_reactor.WaitReadable(in_fd);
+		ssize_t numBytes = read(in_fd, buf, sizeof(buf) - 1);
+		if(numBytes <= 0)
+		{
+			printf("Socket closed (events: 0x%x)\n", events);
+			in_reactor.Stop();
+			co_return;
+		}
+		buf[numBytes] = '\0';
+		printf("Read from socket: %s\n", buf);
+	}
+}
+
+void TestTaskReactor()
+{
+	// Exchange messages over a local Unix socket pair
+	int fds[2];
+	if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+	{
+		printf("Failed to create socket pair\n");
+		return;
+	}
+	TaskReactor reactor;
+	TaskManager taskMgr;
+	auto readTask = taskMgr.Run(ReadSocketTask(reactor, fds[0]));
+	taskMgr.Update();
+	printf("Wake time before write: %d (waiting fds: %d)\n", (int32_t)taskMgr.GetNextWakeTime().type, (int32_t)reactor.GetNumWaitingFds());
+
+	// Let the reactor drive the task manager until the socket is closed (it only wakes when a socket is ready or a timer is due)
+	auto writeTask = taskMgr.Run([](TaskReactor& in_reactor, int in_fd) -> Task<> {
+		TASK_NAME("WriteSocketTask");
+		co_await in_reactor.WaitWritable(in_fd);
+		write(in_fd, "hello", 5);
+		co_await WaitSeconds(TaskTimeFromSeconds(0.1));
+		close(in_fd);
+	}(reactor, fds[1]));
+	int32_t numUpdates = 0;
+	reactor.Run(taskMgr, [&] {
+		TimeSystem::UpdateTime();
+		++numUpdates;
+		return true;
+	});
+	close(fds[0]);
+	printf("Reactor finished after %d updates\n", numUpdates);
+}
+#endif // defined(__linux__)
+
 // Simple main function
 int main(int argc, char** argv)
 {
 	TimeSystem::Create();
 
+	TestTaskGroups();
+	BenchmarkTaskSpawning();
+	TestFastForward();
+	TestTimeStreams();
+	TestTokenList();
+	TestConcurrentTokenList();
+#if defined(__linux__)
+	TestTaskReactor();
+#endif // defined(__linux__)
 	TestTaskFSM();
 
 	return 0;
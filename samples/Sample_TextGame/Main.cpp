@@ -7,7 +7,7 @@
 NAMESPACE_SQUID_BEGIN
 tTaskTime GetGlobalTime()
 {
-	return (tTaskTime)TimeSystem::GetTime();
+	return TaskTimeFromSeconds(TimeSystem::GetTime());
 }
 NAMESPACE_SQUID_END
 
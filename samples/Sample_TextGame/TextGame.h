@@ -2,18 +2,21 @@
 
 #include "TextInput.h"
 
+#include "TaskDataStream.h"
+#include "TaskFileIO.h"
 #include "TaskManager.h"
 #include "TokenList.h"
 #include "FunctionGuard.h"
 
 #include <sstream>
+#include <algorithm>
+#include <list>
 #include <random>
 #include <limits>
 #include <iostream>
 #include <map>
 #include <set>
 #include <vector>
-#include <fstream>
 #include <tuple>
 
 using namespace Squid;
@@ -49,7 +52,7 @@ Task<> PeriodicallyPrintDebug(float in_delay, TaskManager& in_taskMgr)
 	TextGameDebugStackFormatter formatter;
 	while(true)
 	{
-		co_await WaitSeconds(in_delay);
+		co_await WaitSeconds(TaskTimeFromSeconds(in_delay));
 		std::cout << "Currently running tasks:" << std::endl << in_taskMgr.GetDebugString(formatter) << std::endl;
 	}
 }
@@ -60,6 +63,7 @@ public:
 	TextGame()
 		: m_mersenne(m_randDev())
 	{
+		m_taskMgr.AddTimeStream(m_gameTime);
 		m_taskMgr.RunManaged(MainLoop());
 
 #if TEXTGAME_ENABLE_PERIODIC_DEBUG
@@ -85,6 +89,7 @@ private:
 	std::uniform_real_distribution<float> m_randFloat = std::uniform_real_distribution<float>(0.0, 1.0);
 
 	// Task Management
+	TimeStream m_gameTime = TimeStream(GetGlobalTime); // Times status effects (snapshotted by m_taskMgr)
 	TaskManager m_taskMgr;
 	TextInput m_textInput;
 	bool m_isGameOver = false;
@@ -165,43 +170,50 @@ private:
 		// Save/Load
 		void SaveToFile()
 		{
-			std::ofstream saveFile("saves/" + name + ".gqs");
-			auto WriteToFile = [&saveFile](const auto& in_val) {
-				saveFile.write((char*)&in_val, sizeof(in_val));
+			std::ostringstream saveData;
+			auto WriteToFile = [&saveData](const auto& in_val) {
+				saveData.write((char*)&in_val, sizeof(in_val));
 			};
-			auto WriteStrToFile = [&saveFile, WriteToFile](const std::string& in_val) {
+			auto WriteStrToFile = [&saveData, WriteToFile](const std::string& in_val) {
 				WriteToFile((int32_t)in_val.size());
-				saveFile.write(&in_val[0], in_val.size());
+				saveData.write(&in_val[0], in_val.size());
 			};
-			if(saveFile.is_open())
+			WriteToFile(SAVE_FORMAT_VERSION);
+			WriteStrToFile(name);
+			WriteToFile(health);
+			WriteToFile(maxHealth);
+			WriteToFile(mana);
+			WriteToFile(maxMana);
+			WriteToFile(xp);
+			WriteToFile(level);
+			WriteToFile(maxStage);
+			WriteToFile(strength);
+			WriteToFile(armor);
+			WriteToFile(defense);
+			WriteToFile(speed);
+			WriteToFile(baseAttackDelay);
+			WriteToFile(intelligence);
+			WriteToFile(skillPoints);
+			WriteToFile(maxSkillPoints);
+			WriteToFile((int32_t)spellBook.size());
+			for(const auto& spell : spellBook)
 			{
-				WriteToFile(SAVE_FORMAT_VERSION);
-				WriteStrToFile(name);
-				WriteToFile(health);
-				WriteToFile(maxHealth);
-				WriteToFile(mana);
-				WriteToFile(maxMana);
-				WriteToFile(xp);
-				WriteToFile(level);
-				WriteToFile(maxStage);
-				WriteToFile(strength);
-				WriteToFile(armor);
-				WriteToFile(defense);
-				WriteToFile(speed);
-				WriteToFile(baseAttackDelay);
-				WriteToFile(intelligence);
-				WriteToFile(skillPoints);
-				WriteToFile(maxSkillPoints);
-				WriteToFile((int32_t)spellBook.size());
-				for(const auto& spell : spellBook)
-				{
-					WriteStrToFile(spell.second.name);
-				}
+				WriteStrToFile(spell.second.name);
 			}
+
+			// Save in the background (queued writes complete even though we do not await the result)
+			WriteFileAsync("saves/" + name + ".gqs", saveData.str());
 		}
-		bool LoadFromFile(TextGame* in_game)
+		Task<bool> LoadFromFile(TextGame* in_game)
 		{
-			std::ifstream saveFile("saves/" + name + ".gqs");
+			TASK_NAME(__FUNCTION__);
+
+			auto saveData = co_await ReadFileAsync("saves/" + name + ".gqs");
+			if(!saveData)
+			{
+				co_return false;
+			}
+			std::istringstream saveFile(saveData.value());
 			auto ReadFromFile = [&saveFile](auto& out_val) {
 				saveFile.read((char*)&out_val, sizeof(out_val));
 			};
@@ -211,41 +223,37 @@ private:
 				out_val.resize(strSize);
 				saveFile.read(&out_val[0], strSize);
 			};
-			if(saveFile.is_open())
+			int32_t version = 0;
+			ReadFromFile(version);
+			ReadStrFromFile(name);
+			ReadFromFile(health);
+			ReadFromFile(maxHealth);
+			ReadFromFile(mana);
+			ReadFromFile(maxMana);
+			ReadFromFile(xp);
+			ReadFromFile(level);
+			ReadFromFile(maxStage);
+			ReadFromFile(strength);
+			ReadFromFile(armor);
+			ReadFromFile(defense);
+			ReadFromFile(speed);
+			ReadFromFile(baseAttackDelay);
+			ReadFromFile(intelligence);
+			ReadFromFile(skillPoints);
+			ReadFromFile(maxSkillPoints);
+			int32_t spellBookSize = 0;
+			ReadFromFile(spellBookSize);
+			while(spellBookSize-- > 0)
 			{
-				int32_t version = 0;
-				ReadFromFile(version);
-				ReadStrFromFile(name);
-				ReadFromFile(health);
-				ReadFromFile(maxHealth);
-				ReadFromFile(mana);
-				ReadFromFile(maxMana);
-				ReadFromFile(xp);
-				ReadFromFile(level);
-				ReadFromFile(maxStage);
-				ReadFromFile(strength);
-				ReadFromFile(armor);
-				ReadFromFile(defense);
-				ReadFromFile(speed);
-				ReadFromFile(baseAttackDelay);
-				ReadFromFile(intelligence);
-				ReadFromFile(skillPoints);
-				ReadFromFile(maxSkillPoints);
-				int32_t spellBookSize = 0;
-				ReadFromFile(spellBookSize);
-				while(spellBookSize-- > 0)
+				std::string spellName;
+				ReadStrFromFile(spellName);
+				auto spell = in_game->GetSpellByName(spellName);
+				if(spell)
 				{
-					std::string spellName;
-					ReadStrFromFile(spellName);
-					auto spell = in_game->GetSpellByName(spellName);
-					if(spell)
-					{
-						LearnSpell(spell.value());
-					}
+					LearnSpell(spell.value());
 				}
-				return true;
 			}
-			return false;
+			co_return true;
 		}
 
 		// Stats debug output
@@ -284,48 +292,70 @@ private:
 	// Game Data
 	struct GameData
 	{
-		using tWords = std::vector<std::vector<std::string>>;
-		tWords words;
+		using tWords = std::vector<std::vector<std::string_view>>;
+		tWords words; // (Views into wordsFile, or into normalizedWords for words that contained whitespace)
+		std::list<std::string> normalizedWords;
 		std::vector<std::tuple<std::string, std::string>> riddles;
 		std::vector<std::tuple<std::string, std::vector<std::string>, std::vector<std::string>>> nyms;
+		MappedFile wordsFile;
+		MappedFile nymsFile;
 
-		void LoadData(TextGame* in_game)
+		Task<> LoadData(TextGame* in_game)
 		{
-			// Load words list
-			std::string line;
-			std::ifstream wordsFile("gamedata/words.txt");
+			TASK_NAME(__FUNCTION__);
+
+			// Start loading the riddles in the background
+			bool encodeRiddles = false;
+			auto riddlesTask = ReadFileAsync(encodeRiddles ? "gamedata/riddles.csv" : "gamedata/riddles_enc.csv");
+
+			// Stream words list (one batch per frame, viewing the mapped file directly)
+			wordsFile.Open("gamedata/words.txt");
+			RecordStream wordsStream(wordsFile.GetData());
 			words.resize(16);
 			for(auto& wordList : words)
 			{
 				wordList.reserve(100);
 			}
-			while(std::getline(wordsFile, line))
+			while(co_await wordsStream.NextBatch())
 			{
-				line.erase(remove_if(line.begin(), line.end(), std::isspace), line.end());
-				size_t len = line.size() - 1;
-				len = len >= words.size() ? words.size() - 1 : len;
-				auto& wordList = words[len];
-				wordList.push_back(line);
+				for(std::string_view word : wordsStream.GetBatch())
+				{
+					if(std::any_of(word.begin(), word.end(), [](char c) { return std::isspace((unsigned char)c); }))
+					{
+						// Strip whitespace from a copy of the word (words without whitespace are viewed directly)
+						std::string& normalizedWord = normalizedWords.emplace_back(word);
+						normalizedWord.erase(std::remove_if(normalizedWord.begin(), normalizedWord.end(), [](char c) { return std::isspace((unsigned char)c); }), normalizedWord.end());
+						word = normalizedWord;
+					}
+					size_t len = word.size() - 1;
+					len = len >= words.size() ? words.size() - 1 : len;
+					auto& wordList = words[len];
+					wordList.push_back(word);
+				}
 			}
 
-			// Load antonyms list
-			std::ifstream nymsFile("gamedata/nyms.csv");
-			while(std::getline(nymsFile, line))
+			// Stream antonyms list
+			nymsFile.Open("gamedata/nyms.csv");
+			RecordStream nymsStream(nymsFile.GetData());
+			while(co_await nymsStream.NextBatch())
 			{
-				auto wordStart = 0;
-				auto wordEnd = line.find('\t');
-				auto synEnd = line.find('\t', wordEnd + 1);
-				auto word = line.substr(wordStart, wordEnd);
-				auto synLine = line.substr(wordEnd + 1, synEnd - (wordEnd + 1));
-				auto antLine = line.substr(synEnd + 1);
-				auto syns = Split(synLine, ", ");
-				auto ants = Split(antLine, ", ");
-				nyms.push_back({ word, syns, ants });
+				for(std::string_view line : nymsStream.GetBatch())
+				{
+					auto wordEnd = line.find('\t');
+					auto synEnd = line.find('\t', wordEnd + 1);
+					auto word = line.substr(0, wordEnd);
+					auto synLine = line.substr(wordEnd + 1, synEnd - (wordEnd + 1));
+					auto antLine = synEnd == std::string_view::npos ? std::string_view() : line.substr(synEnd + 1);
+					auto syns = Split(std::string(synLine), ", ");
+					auto ants = Split(std::string(antLine), ", ");
+					nyms.push_back({ std::string(word), syns, ants });
+				}
 			}
 
 			// Load riddles list
-			bool encodeRiddles = false;
-			std::ifstream riddlesFile(encodeRiddles ? "gamedata/riddles.csv" : "gamedata/riddles_enc.csv");
+			std::string line;
+			auto riddlesData = co_await std::move(riddlesTask);
+			std::istringstream riddlesFile(riddlesData.value_or(""));
 			while(std::getline(riddlesFile, line))
 			{
 				auto riddleStart = line.find('\"') + 1;
@@ -344,13 +374,14 @@ private:
 			}
 			if(encodeRiddles)
 			{
-				std::ofstream riddlesEncFile("gamedata/riddles_enc.csv");
+				std::ostringstream riddlesEncFile;
 				for(const auto& riddleTuple : riddles)
 				{
 					std::string riddle, answer;
 					std::tie(riddle, answer) = riddleTuple;
 					riddlesEncFile << '\"' << Rot13(riddle) << "\"," << Rot13(answer) << std::endl;
 				}
+				co_await WriteFileAsync("gamedata/riddles_enc.csv", riddlesEncFile.str());
 			}
 		}
 	};
@@ -365,7 +396,7 @@ private:
 		GenerateSpellArchive();
 
 		// Load game data
-		m_data.LoadData(this);
+		co_await m_data.LoadData(this);
 
 		// Create player character
 		Character player;
@@ -381,7 +412,7 @@ private:
 			player.name = co_await WaitForInput();
 			NewLine();
 
-			if(!player.LoadFromFile(this))
+			if(!co_await player.LoadFromFile(this))
 			{
 				co_await Teletype(std::string("Welcome, ") + player.name + ", to GeneriQuest!");
 				player.SaveToFile();
@@ -402,7 +433,7 @@ private:
 
 			while(true)
 			{
-				co_await WaitSeconds(player.skillPointRegenRate);
+				co_await WaitSeconds(TaskTimeFromSeconds(player.skillPointRegenRate));
 				if(player.skillPoints < player.maxSkillPoints)
 				{
 					player.skillPoints += 1;
@@ -611,13 +642,13 @@ private:
 		int32_t lenWords = RandInRange(in_minLen, in_maxLen);
 		const auto& wordList = m_data.words[lenWords - 1];
 		auto word = wordList[RandInt() % wordList.size()];
-		return word;
+		return std::string(word);
 	}
 	Task<bool> WaitForInputAndCheck(const std::vector<std::string>& in_words, float in_timeout, const std::string& in_successText, const std::string& in_failureText, const std::string& in_slowText)
 	{
 		TASK_NAME(__FUNCTION__);
 
-		auto input = co_await Timeout(WaitForInput(), in_timeout);
+		auto input = co_await Timeout(WaitForInput(), TaskTimeFromSeconds(in_timeout));
 		NewLine();
 		if(input)
 		{
@@ -758,7 +789,7 @@ private:
 		};
 		std::shuffle(choices.begin(), choices.end(), m_mersenne); // Shuffle choices
 
-		bool fastEnough = co_await Timeout(MultipleChoice(prompt, choices), timePerWord + 3.0f);
+		bool fastEnough = co_await Timeout(MultipleChoice(prompt, choices), TaskTimeFromSeconds(timePerWord + 3.0f));
 		if(fastEnough)
 		{
 			if(correct)
@@ -890,12 +921,8 @@ private:
 			auto attackDelay = in_attacker.baseAttackDelay - (in_attacker.speed * 0.04f);
 			attackDelay *= 2.0f; // Slowing down combat in general
 			attackDelay = attackDelay < 0.1f ? 0.1f : attackDelay;
-			co_await WaitSeconds(attackDelay * hasteBonus + Rand() * 0.1f);
-			bool isStunned = in_attacker.conditions.stunTokens;
-			if(isStunned)
-			{
-				co_await WaitSeconds(2.0f);
-			}
+			co_await WaitSeconds(TaskTimeFromSeconds(attackDelay * hasteBonus + Rand() * 0.1f));
+			co_await in_attacker.conditions.stunTokens.WaitUntilEmpty(); // Stay stunned until every stun wears off
 			float dmg = (float)in_attacker.strength;
 			bool defHasFortify = in_defender.conditions.fortifyTokens;
 			dmg -= in_defender.armor + (defHasFortify ? 2 : 0);
@@ -966,7 +993,7 @@ private:
 								co_await Teletype("You must wait before casting another spell", 0.0, 0.0);
 							}
 						}
-					}(), spell.cooldown);
+					}(), TaskTimeFromSeconds(spell.cooldown));
 
 					continue; // Immediately wait for char input again
 				}
@@ -1018,14 +1045,9 @@ private:
 	{
 		TASK_NAME(__FUNCTION__);
 
-		// Create persistent condition task that grants haste for N seconds
-		in_attacker.conditions.conditionTasks.push_back(m_taskMgr.Run([](Character& in_attacker) -> Task<> {
-			TASK_NAME("Quicken Condition");
-
-			auto token = in_attacker.conditions.hasteTokens.TakeToken("Quicken Spell");
-			float quickenDur = 5.0;
-			co_await WaitSeconds(quickenDur);
-		}(in_attacker))); // NOTE: Non-co_awaited lambda coroutines should always pass in their params, rather than capture them!
+		// Grant haste for N seconds
+		float quickenDur = 5.0;
+		in_attacker.conditions.hasteTokens.TakeTokenFor("Quicken Spell", TaskTimeFromSeconds(quickenDur), m_gameTime);
 
 		std::stringstream quickenStr;
 		quickenStr << "*** " << in_attacker.name << " casts Quicken for " << in_spell.mpCost << " MP!";
@@ -1045,7 +1067,7 @@ private:
 
 			while(totalRegens-- > 0)
 			{
-				co_await WaitSeconds(regenDelayTime);
+				co_await WaitSeconds(TaskTimeFromSeconds(regenDelayTime));
 				auto healAmount = Lookup(in_attacker.intelligence, std::vector<int32_t>{0, 1, 2, 2, 2, 2, 2, 2, 3, 3, 3});
 				in_attacker.health += healAmount; // Heal attacker
 				in_attacker.health = in_attacker.health > in_attacker.maxHealth ? in_attacker.maxHealth : in_attacker.health;
@@ -1074,7 +1096,7 @@ private:
 
 			while(totalPoisons-- > 0)
 			{
-				co_await WaitSeconds(poisonDelayTime);
+				co_await WaitSeconds(TaskTimeFromSeconds(poisonDelayTime));
 				auto dmg = Lookup(in_attacker.intelligence, std::vector<int32_t>{0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2});
 				in_defender.health -= dmg; // Heal attacker
 				in_defender.health = in_defender.health < 0 ? 0 : in_defender.health;
@@ -1093,14 +1115,9 @@ private:
 	{
 		TASK_NAME(__FUNCTION__);
 
-		// Create persistent condition task that stuns enemy for N seconds
-		in_attacker.conditions.conditionTasks.push_back(m_taskMgr.Run([](Character& in_attacker, Character& in_defender) -> Task<> {
-			TASK_NAME("Stun Condition");
-
-			auto token = in_defender.conditions.stunTokens.TakeToken("Stun Spell");
-			float stunDur = (float)Lookup(in_attacker.intelligence, std::vector<int32_t>{0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2});
-			co_await WaitSeconds(stunDur);
-		}(in_attacker, in_defender))); // NOTE: Non-co_awaited lambda coroutines should always pass in their params, rather than capture them!
+		// Stun enemy for N seconds
+		float stunDur = (float)Lookup(in_attacker.intelligence, std::vector<int32_t>{0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2});
+		in_defender.conditions.stunTokens.TakeTokenFor("Stun Spell", TaskTimeFromSeconds(stunDur), m_gameTime);
 
 		std::stringstream stunStr;
 		stunStr << "*** " << in_attacker.name << " casts Stun for " << in_spell.mpCost << " MP!";
@@ -1110,14 +1127,9 @@ private:
 	{
 		TASK_NAME(__FUNCTION__);
 
-		// Create persistent condition task that fortifies enemy for 5 seconds
-		in_attacker.conditions.conditionTasks.push_back(m_taskMgr.Run([](Character& in_attacker) -> Task<> {
-			TASK_NAME("Fortify Condition");
-
-			auto token = in_attacker.conditions.fortifyTokens.TakeToken("Fortify Spell");
-			float fortifyDur = 5.0;
-			co_await WaitSeconds(fortifyDur);
-		}(in_attacker))); // NOTE: Non-co_awaited lambda coroutines should always pass in their params, rather than capture them!
+		// Fortify attacker for 5 seconds
+		float fortifyDur = 5.0;
+		in_attacker.conditions.fortifyTokens.TakeTokenFor("Fortify Spell", TaskTimeFromSeconds(fortifyDur), m_gameTime);
 
 		std::stringstream fortifyStr;
 		fortifyStr << "*** " << in_attacker.name << " casts Fortify for " << in_spell.mpCost << " MP!";
@@ -1336,9 +1348,9 @@ private:
 		for(auto c : in_str)
 		{
 			std::cout << c;
-			co_await WaitSeconds(in_rate);
+			co_await WaitSeconds(TaskTimeFromSeconds(in_rate));
 		}
-		co_await WaitSeconds(in_delay);
+		co_await WaitSeconds(TaskTimeFromSeconds(in_delay));
 		NewLine();
 	}
 	Task<> TeletypeChoice(const std::string& in_str, float in_delay = 0.25, float in_rate = 0.02)